@@ -123,6 +123,27 @@ module Sram_512x128(
   initial begin
     randomMemoryAll;
   end
+
+  // Zero-time backdoor access for simulation hosts. The signatures match
+  // prim_util_memload.svh, so these can be driven by MemArea as well.
+  export "DPI-C" function simutil_set_mem;
+  function int simutil_set_mem(input int index, input bit [311:0] val);
+    if (index >= 512) begin
+      return 0;
+    end
+    mem[index] = val[127:0];
+    return 1;
+  endfunction
+
+  export "DPI-C" function simutil_get_mem;
+  function int simutil_get_mem(input int index, output bit [311:0] val);
+    val = '0;
+    if (index >= 512) begin
+      return 0;
+    end
+    val[127:0] = mem[index];
+    return 1;
+  endfunction
 `endif
 
   always @(posedge clock) begin
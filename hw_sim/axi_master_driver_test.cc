@@ -0,0 +1,329 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Drives AxiMasterReadDriver and AxiMasterWriteDriver from a scripted
+// manager in place of the core, checking burst addressing, read latency,
+// throttling and independent address/data channels.
+
+#include <cstdint>
+#include <vector>
+
+#include "hw_sim/hw_primitives.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+// The drivers only need a model to evaluate; all signals live in Pins.
+struct NullModel {
+  void eval() {}
+};
+
+struct Pins {
+  uint8_t clock = 0;
+  // AR
+  uint8_t ar_valid = 0;
+  uint32_t ar_addr = 0;
+  uint8_t ar_prot = 0, ar_id = 0, ar_len = 0, ar_size = 0, ar_burst = 0;
+  uint8_t ar_lock = 0, ar_cache = 0, ar_qos = 0, ar_region = 0;
+  uint8_t ar_ready = 0;
+  // R
+  uint8_t r_valid = 0;
+  VlWide<4> r_data = {};
+  uint8_t r_id = 0, r_resp = 0, r_last = 0;
+  uint8_t r_ready = 1;
+  // AW
+  uint8_t aw_valid = 0;
+  uint32_t aw_addr = 0;
+  uint8_t aw_prot = 0, aw_id = 0, aw_len = 0, aw_size = 0, aw_burst = 0;
+  uint8_t aw_lock = 0, aw_cache = 0, aw_qos = 0, aw_region = 0;
+  uint8_t aw_ready = 0;
+  // W
+  uint8_t w_valid = 0;
+  VlWide<4> w_data = {};
+  uint16_t w_strb = 0;
+  uint8_t w_last = 0;
+  uint8_t w_ready = 0;
+  // B
+  uint8_t b_valid = 0;
+  uint8_t b_id = 0, b_resp = 0;
+  uint8_t b_ready = 1;
+};
+
+struct Beat {
+  uint64_t cycle;
+  uint32_t data;
+  uint8_t id;
+  uint8_t last;
+};
+
+// Plays the core's side of the master port. Registered after the drivers, so
+// it samples the same edge and drives after them.
+class Manager : public Clock::Observer {
+ public:
+  Manager(Clock* clock, Pins* pins) : Clock::Observer(clock), pins_(pins) {}
+
+  // Queues a read address, presented from cycle `at`.
+  void Read(uint64_t at, uint8_t id, uint32_t addr, uint8_t len,
+            uint8_t burst) {
+    reads_.push_back({at, MakeAddr(id, addr, len, burst)});
+  }
+  // Queues a write address from cycle `addr_at` and its beats from cycle
+  // `data_at`. Each beat's first word holds its index.
+  void Write(uint64_t addr_at, uint64_t data_at, uint8_t id, uint32_t addr,
+             uint8_t len, uint8_t burst) {
+    writes_.push_back({addr_at, MakeAddr(id, addr, len, burst)});
+    for (uint32_t i = 0; i <= len; i++) {
+      beats_.push_back({data_at, i, static_cast<uint8_t>(i == len)});
+    }
+  }
+
+  uint64_t cycle() const { return cycle_; }
+  const std::vector<uint64_t>& read_accepted() const { return read_accepted_; }
+  const std::vector<Beat>& read_beats() const { return read_beats_; }
+  const std::vector<AxiWResp>& write_resps() const { return write_resps_; }
+  bool done() const {
+    return reads_.empty() && writes_.empty() && beats_.empty();
+  }
+
+ private:
+  struct Timed {
+    uint64_t at;
+    AxiAddr addr;
+  };
+  struct WBeat {
+    uint64_t at;
+    uint32_t index;
+    uint8_t last;
+  };
+
+  static AxiAddr MakeAddr(uint8_t id, uint32_t addr, uint8_t len,
+                          uint8_t burst) {
+    AxiAddr a = {};
+    a.addr_bits_addr = addr;
+    a.addr_bits_id = id;
+    a.addr_bits_len = len;
+    a.addr_bits_size = 4;
+    a.addr_bits_burst = burst;
+    return a;
+  }
+
+  void Sample() final {
+    if (pins_->ar_valid && pins_->ar_ready) {
+      reads_.erase(reads_.begin());
+      read_accepted_.push_back(cycle_);
+    }
+    if (pins_->r_valid && pins_->r_ready) {
+      read_beats_.push_back(
+          {cycle_, pins_->r_data[0], pins_->r_id, pins_->r_last});
+    }
+    if (pins_->aw_valid && pins_->aw_ready) {
+      writes_.erase(writes_.begin());
+    }
+    if (pins_->w_valid && pins_->w_ready) {
+      beats_.erase(beats_.begin());
+    }
+    if (pins_->b_valid && pins_->b_ready) {
+      write_resps_.push_back({pins_->b_id, pins_->b_resp});
+    }
+  }
+
+  void Drive() final {
+    cycle_++;
+    pins_->ar_valid = !reads_.empty() && reads_.front().at <= cycle_;
+    if (pins_->ar_valid) {
+      const AxiAddr& a = reads_.front().addr;
+      pins_->ar_addr = a.addr_bits_addr;
+      pins_->ar_id = a.addr_bits_id;
+      pins_->ar_len = a.addr_bits_len;
+      pins_->ar_size = a.addr_bits_size;
+      pins_->ar_burst = a.addr_bits_burst;
+    }
+    pins_->aw_valid = !writes_.empty() && writes_.front().at <= cycle_;
+    if (pins_->aw_valid) {
+      const AxiAddr& a = writes_.front().addr;
+      pins_->aw_addr = a.addr_bits_addr;
+      pins_->aw_id = a.addr_bits_id;
+      pins_->aw_len = a.addr_bits_len;
+      pins_->aw_size = a.addr_bits_size;
+      pins_->aw_burst = a.addr_bits_burst;
+    }
+    pins_->w_valid = !beats_.empty() && beats_.front().at <= cycle_;
+    if (pins_->w_valid) {
+      pins_->w_data[0] = beats_.front().index;
+      pins_->w_strb = 0xffff;
+      pins_->w_last = beats_.front().last;
+    }
+  }
+
+  Pins* const pins_;
+  uint64_t cycle_ = 0;
+  std::vector<Timed> reads_;
+  std::vector<Timed> writes_;
+  std::vector<WBeat> beats_;
+  std::vector<uint64_t> read_accepted_;
+  std::vector<Beat> read_beats_;
+  std::vector<AxiWResp> write_resps_;
+};
+
+// A port with both drivers, the manager and logs of the callback addresses.
+struct Port {
+  explicit Port(const AxiMasterTiming& timing)
+      : clock(&context, &pins.clock, &model),
+        read_driver(&clock, &pins.ar_valid, &pins.ar_addr, &pins.ar_prot,
+                    &pins.ar_id, &pins.ar_len, &pins.ar_size, &pins.ar_burst,
+                    &pins.ar_lock, &pins.ar_cache, &pins.ar_qos,
+                    &pins.ar_region, &pins.ar_ready, &pins.r_valid,
+                    &pins.r_data, &pins.r_id, &pins.r_resp, &pins.r_last,
+                    &pins.r_ready),
+        write_driver(&clock, &pins.aw_valid, &pins.aw_addr, &pins.aw_prot,
+                     &pins.aw_id, &pins.aw_len, &pins.aw_size,
+                     &pins.aw_burst, &pins.aw_lock, &pins.aw_cache,
+                     &pins.aw_qos, &pins.aw_region, &pins.aw_ready,
+                     &pins.w_valid, &pins.w_data, &pins.w_strb, &pins.w_last,
+                     &pins.w_ready, &pins.b_valid, &pins.b_id, &pins.b_resp,
+                     &pins.b_ready),
+        manager(&clock, &pins) {
+    read_driver.set_timing(timing);
+    write_driver.set_timing(timing);
+    read_driver.RegisterReadCallback([this](const AxiAddr& addr) {
+      read_addrs.push_back(addr.addr_bits_addr);
+      AxiRData data = {};
+      data.read_data_bits_data[0] = addr.addr_bits_addr;
+      return data;
+    });
+    write_driver.RegisterWriteCallback(
+        [this](const AxiAddr& addr, const AxiWData& data) {
+          write_addrs.push_back(addr.addr_bits_addr);
+          write_indices.push_back(data.write_data_bits_data[0]);
+          AxiWResp resp = {};
+          return resp;
+        });
+  }
+
+  // Steps until the manager has issued everything and the drivers are idle.
+  bool Run() {
+    for (int i = 0; i < 1000; i++) {
+      clock.Step();
+      if (manager.done() && read_driver.idle() && write_driver.idle()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  VerilatedContext context;
+  Pins pins;
+  NullModel model;
+  Clock clock;
+  AxiMasterReadDriver read_driver;
+  AxiMasterWriteDriver write_driver;
+  Manager manager;
+  std::vector<uint32_t> read_addrs;
+  std::vector<uint32_t> write_addrs;
+  std::vector<uint32_t> write_indices;
+};
+
+// Cycles from a read address being accepted to its first beat.
+uint64_t FirstBeatDelay(const AxiMasterTiming& timing) {
+  Port port(timing);
+  port.manager.Read(0, 1, 0x40, 0, kAxiBurstIncr);
+  port.Run();
+  return port.manager.read_beats()[0].cycle -
+         port.manager.read_accepted()[0];
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+
+  // A WRAP burst wraps at its total size; beats carry the ID and one last.
+  {
+    Port port(AxiMasterTiming{});
+    port.manager.Read(0, 5, 0x20, 3, kAxiBurstWrap);
+    ok &= Check(port.Run(), "wrap read finished");
+    ok &= Check(port.read_addrs == std::vector<uint32_t>{0x20, 0x30, 0x0, 0x10},
+                "wrap read addresses");
+    const auto& beats = port.manager.read_beats();
+    ok &= Check(beats.size() == 4, "wrap read beats");
+    for (size_t i = 0; i < beats.size(); i++) {
+      ok &= Check(beats[i].id == 5, "read beat id");
+      ok &= Check(beats[i].last == (i == 3), "read beat last");
+      ok &= Check(beats[i].data == port.read_addrs[i], "read beat data");
+      if (i > 0) {
+        ok &= Check(beats[i].cycle == beats[i - 1].cycle + 1,
+                    "back-to-back read beats");
+      }
+    }
+  }
+
+  // Two bursts on different IDs are both accepted before data returns and
+  // are answered in order.
+  {
+    Port port(AxiMasterTiming{8, 1.0});
+    port.manager.Read(0, 1, 0x100, 1, kAxiBurstIncr);
+    port.manager.Read(0, 2, 0x200, 1, kAxiBurstIncr);
+    ok &= Check(port.Run(), "outstanding reads finished");
+    const auto& accepted = port.manager.read_accepted();
+    const auto& beats = port.manager.read_beats();
+    ok &= Check(accepted.size() == 2 && beats.size() == 4, "outstanding");
+    ok &= Check(accepted[1] < beats[0].cycle, "second address accepted early");
+    ok &= Check(beats[0].id == 1 && beats[1].id == 1 && beats[2].id == 2 &&
+                    beats[3].id == 2,
+                "outstanding read order");
+    ok &= Check(port.read_addrs ==
+                    std::vector<uint32_t>{0x100, 0x110, 0x200, 0x210},
+                "incr read addresses");
+  }
+
+  // Read latency delays the first beat by exactly the configured cycles.
+  ok &= Check(FirstBeatDelay(AxiMasterTiming{10, 1.0}) ==
+                  FirstBeatDelay(AxiMasterTiming{}) + 10,
+              "read latency");
+
+  // Half-rate throttling spaces beats two cycles apart.
+  {
+    Port port(AxiMasterTiming{0, 0.5});
+    port.manager.Read(0, 0, 0x0, 7, kAxiBurstIncr);
+    ok &= Check(port.Run(), "throttled read finished");
+    const auto& beats = port.manager.read_beats();
+    ok &= Check(beats.size() == 8, "throttled read beats");
+    for (size_t i = 1; i < beats.size(); i++) {
+      ok &= Check(beats[i].cycle == beats[i - 1].cycle + 2,
+                  "throttled read spacing");
+    }
+  }
+
+  // Write data offered before its address waits for it; data offered after
+  // the address is accepted independently. One response per burst.
+  {
+    Port port(AxiMasterTiming{});
+    port.manager.Write(4, 0, 3, 0x100, 3, kAxiBurstIncr);
+    port.manager.Write(0, 10, 4, 0x300, 2, kAxiBurstFixed);
+    ok &= Check(port.Run(), "writes finished");
+    ok &= Check(port.write_addrs == std::vector<uint32_t>{0x100, 0x110, 0x120,
+                                                          0x130, 0x300, 0x300,
+                                                          0x300},
+                "write addresses");
+    ok &= Check(port.write_indices ==
+                    std::vector<uint32_t>{0, 1, 2, 3, 0, 1, 2},
+                "write data");
+    const auto& resps = port.manager.write_resps();
+    ok &= Check(resps.size() == 2 && resps[0].write_resp_bits_id == 3 &&
+                    resps[1].write_resp_bits_id == 4,
+                "write responses");
+  }
+
+  return TestResult(ok);
+}
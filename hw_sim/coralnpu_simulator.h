@@ -15,7 +15,49 @@
 #ifndef HW_SIM_CORALNPU_SIMULATOR_H_
 #define HW_SIM_CORALNPU_SIMULATOR_H_
 
+#include <cstdint>
+#include <functional>
+#include <future>
+
 #include "hw_sim/mailbox.h"
+#include "hw_sim/perf_counters.h"
+
+// How ReadTCM/WriteTCM reach the TCMs.
+enum class TCMAccessMode {
+  // Transfers are issued over the AXI slave port and take simulated cycles.
+  kAxi,
+  // The TCM SRAM arrays are accessed directly in zero simulated time. Ranges
+  // outside ITCM/DTCM still go over AXI.
+  kBackdoor,
+};
+
+// When an asynchronous run ends of its own accord.
+enum class RunMode {
+  // At the first WFI, or when the core halts.
+  kUntilWfi,
+  // Only when the core halts. WFI parks the core until the next interrupt,
+  // so resident firmware can serve any number of doorbell jobs in one run.
+  kResident,
+};
+
+// How an asynchronous run ended.
+enum class RunStatus {
+  // The core halted or, in RunMode::kUntilWfi, entered WFI.
+  kTerminated,
+  // The cycle budget passed to RunAsync ran out first.
+  kTimeout,
+  // Cancel() was called.
+  kCancelled,
+  // RunAsync was called while another run was in progress; nothing started.
+  kBusy,
+};
+
+// Called on the simulation thread when an asynchronous run ends, before its
+// future becomes ready.
+using TerminationCallback = std::function<void(RunStatus)>;
+
+// Receives the value the core wrote to the mailbox doorbell word.
+using DoorbellCallback = std::function<void(uint32_t value)>;
 
 class CoralNPUSimulator {
  public:
@@ -35,6 +77,117 @@ class CoralNPUSimulator {
   // Begin executing starting with the PC set to the specified address. Returns
   // when the core halts.
   virtual void Run(uint32_t start_addr) = 0;
+
+  // Selects the access mode used by ReadTCM/WriteTCM. Defaults to kAxi.
+  virtual void SetTCMAccessMode(TCMAccessMode mode) = 0;
+
+  // As above, but with the access mode chosen for this call only.
+  virtual void ReadTCM(uint32_t addr, size_t size, char* data,
+                       TCMAccessMode mode) = 0;
+  virtual void WriteTCM(uint32_t addr, size_t size, const char* data,
+                        TCMAccessMode mode) = 0;
+
+  // Number of clock cycles simulated since Create().
+  virtual uint64_t GetCycleCount() = 0;
+
+  // Advances the clock `cycles` cycles.
+  virtual void Step(uint64_t cycles) = 0;
+
+  // Lets Step() and asynchronous runs skip cycles in which the core is in WFI
+  // or halted with no bus activity. Skipped cycles are still counted.
+  virtual void SetIdleSkip(bool idle_skip) = 0;
+
+  // Starts the core at `start_addr` and simulates on a background thread
+  // until it terminates (RunMode::kUntilWfi), `timeout` cycles pass (0 for
+  // no limit) or Cancel() is called. Returns immediately. Other methods may
+  // be called while the run is in progress; TCM and mailbox accesses are
+  // interleaved with the running program. Only one run is in progress at a
+  // time: a second call returns a ready future holding kBusy. Must not be
+  // called from the termination callback.
+  virtual std::future<RunStatus> RunAsync(uint32_t start_addr,
+                                          uint64_t timeout) = 0;
+
+  // Sets the callback invoked when an asynchronous run ends. Applies to runs
+  // started after this call.
+  virtual void SetTerminationCallback(TerminationCallback callback) = 0;
+
+  // Ends the asynchronous run in progress, if any, with kCancelled.
+  virtual void Cancel() = 0;
+
+  // Writes the complete simulator state to `path`, e.g. once a program has
+  // finished its setup, so that later runs can start from that point. Fails
+  // while an asynchronous run is in progress, and always in the _threads<N>
+  // libraries, whose models are not verilated with --savable.
+  virtual bool SaveCheckpoint(const char* path) = 0;
+
+  // Replaces the simulator state with one written by SaveCheckpoint() from
+  // the same library. Fails while an asynchronous run is in progress.
+  virtual bool RestoreCheckpoint(const char* path) = 0;
+
+  // External memory behind the core's AXI master port, at
+  // kExternalMemoryAddr. Pages are allocated on first write or by
+  // MapExternalMemory and otherwise read as zero. Each returns false if the
+  // range is outside the memory. ReadTCM/WriteTCM also reach this memory, so
+  // ELF segments placed in it load directly.
+  virtual bool MapExternalMemory(uint32_t addr, size_t size) = 0;
+  virtual bool FillExternalMemory(uint32_t addr, size_t size,
+                                  uint8_t value) = 0;
+  virtual bool WriteExternalMemory(uint32_t addr, size_t size,
+                                   const char* data) = 0;
+  virtual bool ReadExternalMemory(uint32_t addr, size_t size, char* data) = 0;
+
+  // Maps a host view of [addr, addr + size), which must lie wholly inside
+  // ITCM or DTCM; returns nullptr otherwise. The host reads and writes tensors
+  // in place in the returned buffer, which is synchronized with the TCM only
+  // where work starts and ends, never by Step:
+  //  - the parts the host has written are copied into the TCM by Run,
+  //    RunAsync, SetIrq(true) and UnmapTCM;
+  //  - the whole view is reloaded from the TCM, discarding unflushed host
+  //    writes, by WaitForTermination, a WaitForDoorbell that saw the
+  //    doorbell outside an asynchronous run, the end of an asynchronous run
+  //    and RestoreCheckpoint.
+  // The view must not be touched while an asynchronous run is in progress.
+  // WriteTCM also updates overlapping views, and ReadTCM returns the bytes
+  // written to them but not yet copied into the TCM.
+  virtual char* MapTCM(uint32_t addr, size_t size) = 0;
+  // As MapTCM, but the view is `buffer`, which the caller owns and must keep
+  // valid until it is unmapped. Returns false where MapTCM returns nullptr.
+  virtual bool MapTCMBuffer(uint32_t addr, size_t size, char* buffer) = 0;
+  // Releases a view returned by MapTCM or passed to MapTCMBuffer, first
+  // copying it into the TCM. A MapTCMBuffer buffer is left to the caller.
+  virtual void UnmapTCM(char* view) = 0;
+
+  // Doorbell support for resident firmware that parks in WFI between jobs.
+  // The host posts a request and raises the interrupt with SetIrq(true),
+  // which wakes the core. The core answers by writing the mailbox doorbell
+  // word (kCoralNPUDoorbellWord), which deasserts the interrupt and invokes
+  // the callback on the thread stepping the simulation. The callback runs
+  // once that thread has released the simulator, so it may call back into
+  // it, e.g. to read the mailbox.
+  virtual void SetDoorbellCallback(DoorbellCallback callback) = 0;
+  virtual void SetIrq(bool irq) = 0;
+  // Waits for a doorbell rung since the last SetIrq(true), returning at once
+  // if one already has. With an asynchronous run in progress this blocks
+  // until the run thread sees it (or the run ends); otherwise it steps the
+  // core for at most `timeout` cycles. Returns whether the doorbell rang.
+  virtual bool WaitForDoorbell(uint64_t timeout) = 0;
+
+  // Snapshot of the performance counters; see CoralNPUPerfCounters. Safe to
+  // call during an asynchronous run, and cheap enough to call per job.
+  virtual CoralNPUPerfCounters ReadPerfCounters() = 0;
+
+  // Copy of the mailbox taken under the simulator lock. Unlike ReadMailbox,
+  // safe during an asynchronous run and from the doorbell callback.
+  virtual CoralNPUMailbox ReadMailboxSnapshot() = 0;
+
+  // As RunAsync above, but ending of its own accord as `mode` says.
+  virtual std::future<RunStatus> RunAsync(uint32_t start_addr,
+                                          uint64_t timeout, RunMode mode) = 0;
 };
 
+// Same as CoralNPUSimulator::Create(), under an unmangled name for hosts that
+// dlopen() simulator libraries, e.g. to compare several builds in one process.
+extern "C" CoralNPUSimulator* CoralNPUSimulatorCreate();
+using CoralNPUSimulatorCreateFn = CoralNPUSimulator* (*)();
+
 #endif  // HW_SIM_CORALNPU_SIMULATOR_H_
@@ -0,0 +1,159 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Exercises the Python bindings of the simulator and SimulatorPool."""
+
+import gc
+import threading
+import unittest
+
+import numpy as np
+
+from bazel_tools.tools.python.runfiles import runfiles
+from hw_sim import coralnpu_simulator_py as coralnpu_simulator
+
+# DTCM heap, unused by either program.
+_SCRATCH_ADDR = 0x14000
+_TIMEOUT_CYCLES = 100000
+_TIMEOUT_S = 60
+
+
+def _elf_path(name):
+    return runfiles.Create().Rlocation(f"coralnpu_hw/hw_sim/{name}")
+
+
+class SimulatorTest(unittest.TestCase):
+
+    def setUp(self):
+        self.simulator = coralnpu_simulator.Simulator()
+
+    def test_write_tcm_read_tcm_into(self):
+        modes = coralnpu_simulator.TCMAccessMode
+        for mode in [modes.AXI, modes.BACKDOOR]:
+            data = np.arange(256, dtype=np.uint8)
+            if mode == modes.AXI:
+                data = data[::-1].copy()
+            self.simulator.write_tcm(_SCRATCH_ADDR, data, mode)
+            out = np.zeros(256, dtype=np.uint8)
+            self.simulator.read_tcm_into(_SCRATCH_ADDR, out, mode)
+            np.testing.assert_array_equal(out, data)
+
+        self.simulator.write_tcm(_SCRATCH_ADDR, b"\x01\x02\x03\x04")
+        out = bytearray(4)
+        self.simulator.read_tcm_into(_SCRATCH_ADDR, out)
+        self.assertEqual(out, bytearray(b"\x01\x02\x03\x04"))
+
+    def test_map_tcm_unmap_tcm(self):
+        self.assertIsNone(self.simulator.map_tcm(0x30000, 16))
+        view = self.simulator.map_tcm(_SCRATCH_ADDR, 64)
+        view[:] = 7
+        self.simulator.step(1)
+        np.testing.assert_array_equal(
+            self.simulator.read_tcm(_SCRATCH_ADDR, 64,
+                                    coralnpu_simulator.TCMAccessMode.AXI),
+            np.full(64, 7, dtype=np.uint8))
+
+        # After unmap_tcm the array is a plain copy, detached from the TCM.
+        view[:] = 9
+        self.simulator.unmap_tcm(view)
+        view[:] = 11
+        self.simulator.step(1)
+        np.testing.assert_array_equal(
+            self.simulator.read_tcm(_SCRATCH_ADDR, 64),
+            np.full(64, 9, dtype=np.uint8))
+        with self.assertRaises(ValueError):
+            self.simulator.unmap_tcm(np.zeros(64, dtype=np.uint8))
+
+        # A view dropped without unmap_tcm is flushed and released.
+        view = self.simulator.map_tcm(_SCRATCH_ADDR, 64)
+        view[:] = 13
+        del view
+        gc.collect()
+        np.testing.assert_array_equal(
+            self.simulator.read_tcm(_SCRATCH_ADDR, 64),
+            np.full(64, 13, dtype=np.uint8))
+
+    def test_run_async_termination_callback(self):
+        entry_point = self.simulator.load_elf(_elf_path("mailbox_example.elf"))
+        statuses = []
+        self.simulator.set_termination_callback(statuses.append)
+        run = self.simulator.run_async(entry_point, _TIMEOUT_CYCLES)
+        status = run.result(timeout=_TIMEOUT_S)
+        self.assertEqual(status, coralnpu_simulator.RunStatus.TERMINATED)
+        self.assertEqual(statuses, [status])
+        self.assertTrue(run.done())
+        self.assertEqual(self.simulator.read_mailbox()[:2],
+                         (0xDEADBEEF, 0xDEADBEEF))
+
+    def test_doorbell(self):
+        entry_point = self.simulator.load_elf(_elf_path("doorbell_example.elf"))
+        lock = threading.Lock()
+        doorbells = []
+
+        def on_doorbell(value):
+            # Reading back from the callback must not deadlock.
+            mailbox = self.simulator.read_mailbox()
+            with lock:
+                doorbells.append((value, mailbox[2]))
+
+        self.simulator.set_doorbell_callback(on_doorbell)
+
+        def post_job(job):
+            data = np.arange(16, dtype=np.uint32) + job * 100
+            self.simulator.write_tcm(_SCRATCH_ADDR, data)
+            self.simulator.write_mailbox([_SCRATCH_ADDR, len(data), 0, 0])
+            self.simulator.set_irq(True)
+            return int(data.sum())
+
+        # Host-stepped: the firmware parks in WFI between jobs.
+        self.simulator.run(entry_point)
+        self.assertTrue(self.simulator.wait_for_termination(_TIMEOUT_CYCLES))
+        expected = post_job(1)
+        self.assertTrue(self.simulator.wait_for_doorbell(_TIMEOUT_CYCLES))
+        self.assertEqual(doorbells, [(1, expected)])
+
+        # Asynchronous: the restarted firmware answers from the run thread.
+        doorbells.clear()
+        expected = post_job(2)
+        run = self.simulator.run_async(entry_point, 0)
+        self.assertTrue(self.simulator.wait_for_doorbell(_TIMEOUT_CYCLES))
+        self.assertEqual(run.result(timeout=_TIMEOUT_S),
+                         coralnpu_simulator.RunStatus.TERMINATED)
+        with lock:
+            self.assertEqual(doorbells, [(1, expected)])
+
+
+class SimulatorPoolTest(unittest.TestCase):
+
+    def test_submit(self):
+        pool = coralnpu_simulator.SimulatorPool(2)
+        self.assertEqual(pool.size, 2)
+        elf = coralnpu_simulator.ElfImage(_elf_path("mailbox_example.elf"))
+        jobs = []
+        for i in range(4):
+            data = np.full(32, i, dtype=np.uint8)
+            jobs.append((data, pool.submit(
+                elf, inputs=[(_SCRATCH_ADDR, data)],
+                outputs=[(_SCRATCH_ADDR, len(data), data)],
+                timeout=_TIMEOUT_CYCLES)))
+        for data, job in jobs:
+            result = job.result(timeout=_TIMEOUT_S)
+            self.assertTrue(result["terminated"])
+            self.assertTrue(result["passed"])
+            self.assertEqual(result["mailbox"][:2], (0xDEADBEEF, 0xDEADBEEF))
+            np.testing.assert_array_equal(result["outputs"][0], data)
+
+
+if __name__ == "__main__":
+    unittest.main()
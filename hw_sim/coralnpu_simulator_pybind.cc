@@ -0,0 +1,659 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Python bindings for CoralNPUSimulator and SimulatorPool. The module name is
+// set per simulator variant by CORALNPU_SIMULATOR_MODULE.
+//
+// TCM transfers never copy on the host side: write_tcm reads straight from
+// any C-contiguous buffer-protocol object (bytes, bytearray, memoryview, NumPy
+// array), read_tcm_into fills a writable one in place, and map_tcm returns a
+// NumPy array that is itself the simulator's TCM view.
+//
+// Every call into the simulator releases the GIL. Callbacks from the run
+// thread (termination, doorbell) take it again before entering Python, so
+// they must not be blocked on by a caller that still holds it.
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+#include "hw_sim/mailbox.h"
+#include "hw_sim/perf_counters.h"
+#include "hw_sim/simulator_pool.h"
+#include "tests/verilator_sim/elf.h"
+
+#ifndef CORALNPU_SIMULATOR_MODULE
+#define CORALNPU_SIMULATOR_MODULE coralnpu_simulator_py
+#endif
+
+namespace py = pybind11;
+
+namespace {
+
+// Holds a C-contiguous view of a buffer-protocol object for the lifetime of
+// the call, so its memory can be handed to the simulator without copying.
+class ContiguousBuffer {
+ public:
+  ContiguousBuffer(const py::object& object, bool writable) {
+    int flags = PyBUF_C_CONTIGUOUS | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(object.ptr(), &view_, flags) != 0) {
+      throw py::error_already_set();
+    }
+  }
+  ~ContiguousBuffer() { PyBuffer_Release(&view_); }
+  ContiguousBuffer(const ContiguousBuffer&) = delete;
+  ContiguousBuffer& operator=(const ContiguousBuffer&) = delete;
+
+  char* data() const { return static_cast<char*>(view_.buf); }
+  size_t size() const { return static_cast<size_t>(view_.len); }
+
+ private:
+  Py_buffer view_;
+};
+
+// Wraps a Python callable so that the std::function holding it can be copied
+// and destroyed on simulator threads without the GIL.
+template <typename... Args>
+std::function<void(Args...)> WrapCallback(const py::object& callable) {
+  if (callable.is_none()) {
+    return nullptr;
+  }
+  std::shared_ptr<py::function> function(
+      new py::function(callable), [](py::function* f) {
+        py::gil_scoped_acquire gil;
+        delete f;
+      });
+  return [function](Args... args) {
+    py::gil_scoped_acquire gil;
+    try {
+      (*function)(args...);
+    } catch (py::error_already_set& e) {
+      e.discard_as_unraisable("CoralNPU simulator callback");
+    }
+  };
+}
+
+// Waits on `future` with the GIL released. Raises TimeoutError if it is not
+// ready within `timeout` seconds.
+template <typename T>
+void WaitForFuture(const std::future<T>& future,
+                   std::optional<double> timeout) {
+  bool ready;
+  {
+    py::gil_scoped_release release;
+    if (timeout.has_value()) {
+      ready = future.wait_for(std::chrono::duration<double>(*timeout)) ==
+              std::future_status::ready;
+    } else {
+      future.wait();
+      ready = true;
+    }
+  }
+  if (!ready) {
+    PyErr_SetString(PyExc_TimeoutError, "result not ready");
+    throw py::error_already_set();
+  }
+}
+
+template <typename T>
+bool FutureDone(const std::future<T>& future) {
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// A NumPy array that takes ownership of `data` instead of copying it.
+py::array_t<uint8_t> ToArray(std::vector<uint8_t> data) {
+  auto* owned = new std::vector<uint8_t>(std::move(data));
+  py::capsule free_when_done(owned, [](void* p) {
+    delete static_cast<std::vector<uint8_t>*>(p);
+  });
+  return py::array_t<uint8_t>(owned->size(), owned->data(), free_when_done);
+}
+
+py::tuple MailboxToTuple(const CoralNPUMailbox& mailbox) {
+  return py::make_tuple(mailbox.message[0], mailbox.message[1],
+                        mailbox.message[2], mailbox.message[3]);
+}
+
+CoralNPUMailbox MailboxFromSequence(const std::vector<uint32_t>& words) {
+  if (words.size() != 4) {
+    throw py::value_error("mailbox has exactly 4 words");
+  }
+  CoralNPUMailbox mailbox;
+  for (int i = 0; i < 4; i++) {
+    mailbox.message[i] = words[i];
+  }
+  return mailbox;
+}
+
+py::dict TrafficToDict(const CoralNPUAxiTraffic& traffic) {
+  py::dict result;
+  result["beats"] = traffic.beats;
+  result["bytes"] = traffic.bytes;
+  return result;
+}
+
+py::dict PerfCountersToDict(const CoralNPUPerfCounters& perf) {
+  py::dict result;
+  result["cycles"] = perf.cycles;
+  result["active_cycles"] = perf.active_cycles;
+  result["wfi_cycles"] = perf.wfi_cycles;
+  result["halted_cycles"] = perf.halted_cycles;
+  py::list dispatch_fires;
+  for (uint64_t fires : perf.dispatch_fires) {
+    dispatch_fires.append(fires);
+  }
+  result["dispatch_fires"] = dispatch_fires;
+  result["slave_read"] = TrafficToDict(perf.slave_read);
+  result["slave_write"] = TrafficToDict(perf.slave_write);
+  result["master_read"] = TrafficToDict(perf.master_read);
+  result["master_write"] = TrafficToDict(perf.master_write);
+  return result;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> ReadElf(const std::string& path) {
+  auto elf = SimulatorPool::ReadFile(path);
+  if (!elf) {
+    throw py::value_error("failed to read " + path);
+  }
+  return elf;
+}
+
+// Owns the simulator on behalf of Python. Destruction may join an
+// asynchronous run whose callbacks need the GIL, so it is released first.
+class PySimulator {
+ public:
+  PySimulator() : simulator_(CoralNPUSimulator::Create()) {}
+  ~PySimulator() {
+    py::gil_scoped_release release;
+    simulator_.reset();
+  }
+
+  CoralNPUSimulator* get() const { return simulator_.get(); }
+
+ private:
+  std::unique_ptr<CoralNPUSimulator> simulator_;
+};
+
+// Name of the capsules that own map_tcm arrays, checked by unmap_tcm.
+constexpr char kTcmViewCapsule[] = "coralnpu_simulator.tcm_view";
+
+// Host memory mapped as a TCM view with MapTCMBuffer. Owned by the base
+// capsule of the array map_tcm returns, so the memory outlives every array
+// using it; the view is unmapped by unmap_tcm or, failing that, when the
+// capsule is freed.
+struct PyTcmMapping {
+  // The PySimulator, kept alive while the view is mapped.
+  py::object simulator;
+  std::unique_ptr<char[]> data;
+  bool mapped = false;
+
+  // Requires the GIL.
+  void Unmap() {
+    if (!mapped) {
+      return;
+    }
+    mapped = false;
+    CoralNPUSimulator* sim = simulator.cast<PySimulator&>().get();
+    py::gil_scoped_release release;
+    sim->UnmapTCM(data.get());
+  }
+};
+
+void DestroyTcmMapping(PyObject* capsule) {
+  auto* mapping = static_cast<PyTcmMapping*>(
+      PyCapsule_GetPointer(capsule, kTcmViewCapsule));
+  mapping->Unmap();
+  delete mapping;
+}
+
+class RunFuture {
+ public:
+  explicit RunFuture(std::future<RunStatus> future)
+      : future_(std::move(future)) {}
+
+  RunStatus Result(std::optional<double> timeout) {
+    if (!status_.has_value()) {
+      WaitForFuture(future_, timeout);
+      status_ = future_.get();
+    }
+    return *status_;
+  }
+  bool Done() const { return status_.has_value() || FutureDone(future_); }
+
+ private:
+  std::future<RunStatus> future_;
+  std::optional<RunStatus> status_;
+};
+
+class JobFuture {
+ public:
+  explicit JobFuture(std::future<SimulatorJobResult> future)
+      : future_(std::move(future)) {}
+
+  py::object Result(std::optional<double> timeout) {
+    if (!result_) {
+      WaitForFuture(future_, timeout);
+      SimulatorJobResult result = future_.get();
+      py::list outputs;
+      for (auto& output : result.outputs) {
+        outputs.append(ToArray(std::move(output)));
+      }
+      py::dict dict;
+      dict["terminated"] = result.terminated;
+      dict["passed"] = result.passed;
+      dict["mailbox"] = MailboxToTuple(result.mailbox);
+      dict["outputs"] = outputs;
+      dict["cycles"] = result.cycles;
+      result_ = std::move(dict);
+    }
+    return result_;
+  }
+  bool Done() const { return result_ || FutureDone(future_); }
+
+ private:
+  std::future<SimulatorJobResult> future_;
+  py::object result_;
+};
+
+// Owns the pool; destruction waits for submitted jobs without the GIL.
+class PySimulatorPool {
+ public:
+  PySimulatorPool(int num_threads, bool pin_threads)
+      : pool_(std::make_unique<SimulatorPool>(num_threads, pin_threads)) {}
+  ~PySimulatorPool() {
+    py::gil_scoped_release release;
+    pool_.reset();
+  }
+
+  SimulatorPool* get() const { return pool_.get(); }
+
+ private:
+  std::unique_ptr<SimulatorPool> pool_;
+};
+
+// An ELF image read once and shared by every job that runs it.
+struct PyElfImage {
+  std::shared_ptr<const std::vector<uint8_t>> data;
+};
+
+SimulatorJob MakeJob(const PyElfImage& elf, const py::list& inputs,
+                     const py::list& outputs, py::object expected_mailbox,
+                     int timeout) {
+  SimulatorJob job;
+  job.elf = elf.data;
+  job.timeout = timeout;
+  for (const auto& item : inputs) {
+    auto input = item.cast<py::tuple>();
+    if (input.size() != 2) {
+      throw py::value_error("inputs are (addr, buffer) pairs");
+    }
+    ContiguousBuffer buffer(input[1], /*writable=*/false);
+    const auto* begin = reinterpret_cast<const uint8_t*>(buffer.data());
+    job.inputs.push_back({input[0].cast<uint32_t>(),
+                          std::vector<uint8_t>(begin, begin + buffer.size())});
+  }
+  for (const auto& item : outputs) {
+    auto output = item.cast<py::tuple>();
+    if (output.size() != 2 && output.size() != 3) {
+      throw py::value_error("outputs are (addr, size[, expected]) tuples");
+    }
+    SimulatorOutput out{output[0].cast<uint32_t>(), output[1].cast<size_t>(),
+                        {}};
+    if (output.size() == 3 && !output[2].is_none()) {
+      ContiguousBuffer expected(output[2], /*writable=*/false);
+      const auto* begin = reinterpret_cast<const uint8_t*>(expected.data());
+      out.expected.assign(begin, begin + expected.size());
+    }
+    job.outputs.push_back(std::move(out));
+  }
+  if (!expected_mailbox.is_none()) {
+    job.expected_mailbox = MailboxFromSequence(
+        expected_mailbox.cast<std::vector<uint32_t>>());
+  }
+  return job;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(CORALNPU_SIMULATOR_MODULE, m) {
+  m.doc() = "CoralNPU Verilator simulator.";
+
+  py::enum_<TCMAccessMode>(m, "TCMAccessMode")
+      .value("AXI", TCMAccessMode::kAxi)
+      .value("BACKDOOR", TCMAccessMode::kBackdoor);
+
+  py::enum_<RunMode>(m, "RunMode")
+      .value("UNTIL_WFI", RunMode::kUntilWfi)
+      .value("RESIDENT", RunMode::kResident);
+
+  py::enum_<RunStatus>(m, "RunStatus")
+      .value("TERMINATED", RunStatus::kTerminated)
+      .value("TIMEOUT", RunStatus::kTimeout)
+      .value("CANCELLED", RunStatus::kCancelled)
+      .value("BUSY", RunStatus::kBusy);
+
+  m.def(
+      "lookup_symbol",
+      [](const std::string& elf_path,
+         const std::string& symbol) -> std::optional<uint32_t> {
+        auto elf = ReadElf(elf_path);
+        uint32_t addr;
+        if (!LookupSymbol(elf->data(), symbol, &addr)) {
+          return std::nullopt;
+        }
+        return addr;
+      },
+      py::arg("elf_path"), py::arg("symbol"),
+      "Address of `symbol` in an ELF file, or None.");
+
+  py::class_<RunFuture>(m, "RunFuture")
+      .def("result", &RunFuture::Result, py::arg("timeout") = py::none(),
+           "Waits for the run to end and returns its RunStatus.")
+      .def("done", &RunFuture::Done);
+
+  py::class_<PySimulator>(m, "Simulator")
+      .def(py::init<>())
+      .def(
+          "load_elf",
+          [](PySimulator& self, const std::string& path) {
+            auto elf = ReadElf(path);
+            py::gil_scoped_release release;
+            return LoadElfIntoSimulator(self.get(), elf->data());
+          },
+          py::arg("path"),
+          "Loads an ELF with the current TCM access mode and returns its "
+          "entry point.")
+      .def(
+          "set_tcm_access_mode",
+          [](PySimulator& self, TCMAccessMode mode) {
+            self.get()->SetTCMAccessMode(mode);
+          },
+          py::arg("mode"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "read_tcm",
+          [](PySimulator& self, uint32_t addr, size_t size,
+             std::optional<TCMAccessMode> mode) {
+            py::array_t<uint8_t> result(size);
+            char* data = reinterpret_cast<char*>(result.mutable_data());
+            py::gil_scoped_release release;
+            if (mode.has_value()) {
+              self.get()->ReadTCM(addr, size, data, *mode);
+            } else {
+              self.get()->ReadTCM(addr, size, data);
+            }
+            return result;
+          },
+          py::arg("addr"), py::arg("size"), py::arg("mode") = py::none(),
+          "Reads into a new uint8 array.")
+      .def(
+          "read_tcm_into",
+          [](PySimulator& self, uint32_t addr, const py::object& out,
+             std::optional<TCMAccessMode> mode) {
+            ContiguousBuffer buffer(out, /*writable=*/true);
+            py::gil_scoped_release release;
+            if (mode.has_value()) {
+              self.get()->ReadTCM(addr, buffer.size(), buffer.data(), *mode);
+            } else {
+              self.get()->ReadTCM(addr, buffer.size(), buffer.data());
+            }
+          },
+          py::arg("addr"), py::arg("out"), py::arg("mode") = py::none(),
+          "Fills a writable buffer in place.")
+      .def(
+          "write_tcm",
+          [](PySimulator& self, uint32_t addr, const py::object& data,
+             std::optional<TCMAccessMode> mode) {
+            ContiguousBuffer buffer(data, /*writable=*/false);
+            py::gil_scoped_release release;
+            if (mode.has_value()) {
+              self.get()->WriteTCM(addr, buffer.size(), buffer.data(), *mode);
+            } else {
+              self.get()->WriteTCM(addr, buffer.size(), buffer.data());
+            }
+          },
+          py::arg("addr"), py::arg("data"), py::arg("mode") = py::none())
+      .def(
+          "map_tcm",
+          [](py::object self, uint32_t addr, size_t size) -> py::object {
+            CoralNPUSimulator* simulator = self.cast<PySimulator&>().get();
+            auto mapping = std::make_unique<PyTcmMapping>();
+            mapping->simulator = self;
+            mapping->data = std::make_unique<char[]>(size);
+            {
+              py::gil_scoped_release release;
+              mapping->mapped = simulator->MapTCMBuffer(
+                  addr, size, mapping->data.get());
+            }
+            if (!mapping->mapped) {
+              return py::none();
+            }
+            auto* data = reinterpret_cast<uint8_t*>(mapping->data.get());
+            auto base = py::reinterpret_steal<py::object>(PyCapsule_New(
+                mapping.get(), kTcmViewCapsule, DestroyTcmMapping));
+            if (!base) {
+              throw py::error_already_set();
+            }
+            mapping.release();
+            return py::array_t<uint8_t>(size, data, base);
+          },
+          py::arg("addr"), py::arg("size"),
+          "Returns a uint8 array that is a host view of the TCM (see "
+          "CoralNPUSimulator::MapTCM), or None if the range is not wholly "
+          "inside ITCM or DTCM. The view is released by unmap_tcm or when "
+          "the array is freed.")
+      .def(
+          "unmap_tcm",
+          [](py::object self, py::array view) {
+            py::object base = view.base();
+            if (!base || !PyCapsule_IsValid(base.ptr(), kTcmViewCapsule)) {
+              throw py::value_error("not an array returned by map_tcm");
+            }
+            auto* mapping = static_cast<PyTcmMapping*>(
+                PyCapsule_GetPointer(base.ptr(), kTcmViewCapsule));
+            if (!mapping->simulator.is(self)) {
+              throw py::value_error("array was mapped by another simulator");
+            }
+            mapping->Unmap();
+          },
+          py::arg("view"),
+          "Copies an array returned by map_tcm into the TCM and releases the "
+          "view. The array remains usable as a plain copy.")
+      .def(
+          "read_mailbox",
+          [](PySimulator& self) {
+            CoralNPUMailbox mailbox;
+            {
+              py::gil_scoped_release release;
+              mailbox = self.get()->ReadMailboxSnapshot();
+            }
+            return MailboxToTuple(mailbox);
+          })
+      .def(
+          "write_mailbox",
+          [](PySimulator& self, const std::vector<uint32_t>& words) {
+            CoralNPUMailbox mailbox = MailboxFromSequence(words);
+            py::gil_scoped_release release;
+            self.get()->WriteMailbox(mailbox);
+          },
+          py::arg("words"))
+      .def(
+          "run",
+          [](PySimulator& self, uint32_t start_addr) {
+            self.get()->Run(start_addr);
+          },
+          py::arg("start_addr"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "wait_for_termination",
+          [](PySimulator& self, int timeout) {
+            return self.get()->WaitForTermination(timeout);
+          },
+          py::arg("timeout") = 10000, py::call_guard<py::gil_scoped_release>())
+      .def(
+          "step",
+          [](PySimulator& self, uint64_t cycles) { self.get()->Step(cycles); },
+          py::arg("cycles"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "set_idle_skip",
+          [](PySimulator& self, bool idle_skip) {
+            self.get()->SetIdleSkip(idle_skip);
+          },
+          py::arg("idle_skip"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "get_cycle_count",
+          [](PySimulator& self) { return self.get()->GetCycleCount(); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "run_async",
+          [](PySimulator& self, uint32_t start_addr, uint64_t timeout,
+             RunMode mode) {
+            py::gil_scoped_release release;
+            return std::make_unique<RunFuture>(
+                self.get()->RunAsync(start_addr, timeout, mode));
+          },
+          py::arg("start_addr"), py::arg("timeout") = 0,
+          py::arg("mode") = RunMode::kUntilWfi)
+      .def(
+          "set_termination_callback",
+          [](PySimulator& self, const py::object& callback) {
+            auto wrapped = WrapCallback<RunStatus>(callback);
+            py::gil_scoped_release release;
+            self.get()->SetTerminationCallback(std::move(wrapped));
+          },
+          py::arg("callback"),
+          "Called with the RunStatus on the run thread; None clears it.")
+      .def(
+          "cancel", [](PySimulator& self) { self.get()->Cancel(); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "save_checkpoint",
+          [](PySimulator& self, const std::string& path) {
+            return self.get()->SaveCheckpoint(path.c_str());
+          },
+          py::arg("path"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "restore_checkpoint",
+          [](PySimulator& self, const std::string& path) {
+            return self.get()->RestoreCheckpoint(path.c_str());
+          },
+          py::arg("path"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "map_external_memory",
+          [](PySimulator& self, uint32_t addr, size_t size) {
+            return self.get()->MapExternalMemory(addr, size);
+          },
+          py::arg("addr"), py::arg("size"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "fill_external_memory",
+          [](PySimulator& self, uint32_t addr, size_t size, uint8_t value) {
+            return self.get()->FillExternalMemory(addr, size, value);
+          },
+          py::arg("addr"), py::arg("size"), py::arg("value"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "write_external_memory",
+          [](PySimulator& self, uint32_t addr, const py::object& data) {
+            ContiguousBuffer buffer(data, /*writable=*/false);
+            py::gil_scoped_release release;
+            return self.get()->WriteExternalMemory(addr, buffer.size(),
+                                                   buffer.data());
+          },
+          py::arg("addr"), py::arg("data"))
+      .def(
+          "read_external_memory_into",
+          [](PySimulator& self, uint32_t addr, const py::object& out) {
+            ContiguousBuffer buffer(out, /*writable=*/true);
+            py::gil_scoped_release release;
+            return self.get()->ReadExternalMemory(addr, buffer.size(),
+                                                  buffer.data());
+          },
+          py::arg("addr"), py::arg("out"))
+      .def(
+          "set_doorbell_callback",
+          [](PySimulator& self, const py::object& callback) {
+            auto wrapped = WrapCallback<uint32_t>(callback);
+            py::gil_scoped_release release;
+            self.get()->SetDoorbellCallback(std::move(wrapped));
+          },
+          py::arg("callback"),
+          "Called with the doorbell value on the thread stepping the "
+          "simulation; None clears it.")
+      .def(
+          "set_irq",
+          [](PySimulator& self, bool irq) { self.get()->SetIrq(irq); },
+          py::arg("irq"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "wait_for_doorbell",
+          [](PySimulator& self, uint64_t timeout) {
+            return self.get()->WaitForDoorbell(timeout);
+          },
+          py::arg("timeout"), py::call_guard<py::gil_scoped_release>())
+      .def("read_perf_counters", [](PySimulator& self) {
+        CoralNPUPerfCounters perf;
+        {
+          py::gil_scoped_release release;
+          perf = self.get()->ReadPerfCounters();
+        }
+        return PerfCountersToDict(perf);
+      });
+
+  py::class_<PyElfImage>(m, "ElfImage")
+      .def(py::init([](const std::string& path) {
+             return PyElfImage{ReadElf(path)};
+           }),
+           py::arg("path"))
+      .def("__len__", [](const PyElfImage& self) { return self.data->size(); });
+
+  py::class_<JobFuture>(m, "JobFuture")
+      .def("result", &JobFuture::Result, py::arg("timeout") = py::none(),
+           "Waits for the job and returns a dict with terminated, passed, "
+           "mailbox, outputs (uint8 arrays) and cycles.")
+      .def("done", &JobFuture::Done);
+
+  py::class_<PySimulatorPool>(m, "SimulatorPool")
+      .def(py::init<int, bool>(), py::arg("num_threads"),
+           py::arg("pin_threads") = false)
+      .def(
+          "submit",
+          [](PySimulatorPool& self, const PyElfImage& elf,
+             const py::list& inputs, const py::list& outputs,
+             py::object expected_mailbox, int timeout) {
+            SimulatorJob job =
+                MakeJob(elf, inputs, outputs, expected_mailbox, timeout);
+            py::gil_scoped_release release;
+            return std::make_unique<JobFuture>(
+                self.get()->Submit(std::move(job)));
+          },
+          py::arg("elf"), py::arg("inputs") = py::list(),
+          py::arg("outputs") = py::list(),
+          py::arg("expected_mailbox") = py::none(),
+          py::arg("timeout") = 10000,
+          "Queues a job. inputs are (addr, buffer) pairs; outputs are "
+          "(addr, size) or (addr, size, expected) tuples.")
+      .def_property_readonly("size", [](const PySimulatorPool& self) {
+        return self.get()->size();
+      });
+}
@@ -12,6 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "hw_sim/core_mini_axi_wrapper.h"
@@ -20,19 +29,16 @@
 class CoreMiniAxiSimulator : public CoralNPUSimulator {
  public:
   CoreMiniAxiSimulator() : context_(), wrapper_(&context_) {
-    auto read_cb = [this](const AxiAddr& axi_addr) {
-      return this->ReadCallback(axi_addr);
-    };
-    wrapper_.RegisterReadCallback(read_cb);
-
-    auto write_cb = [this](const AxiAddr& axi_addr, const AxiWData& axi_data) {
-      return this->WriteCallback(axi_addr, axi_data);
-    };
-    wrapper_.RegisterWriteCallback(write_cb);
-
+    wrapper_.SetDoorbellCallback([this](uint32_t value) { OnDoorbell(value); });
     wrapper_.Reset();
   }
-  ~CoreMiniAxiSimulator() final = default;
+  ~CoreMiniAxiSimulator() final {
+    Cancel();
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    if (run_thread_.joinable()) {
+      run_thread_.join();
+    }
+  }
 
   void ReadTCM(uint32_t addr, size_t size, char* data) final;
   const CoralNPUMailbox& ReadMailbox(void) final;
@@ -40,18 +46,137 @@ class CoreMiniAxiSimulator : public CoralNPUSimulator {
   void WriteMailbox(const CoralNPUMailbox& mailbox) final;
   void Run(uint32_t start_addr) final;
   bool WaitForTermination(int timeout) final;
+  void SetTCMAccessMode(TCMAccessMode mode) final;
+  void ReadTCM(uint32_t addr, size_t size, char* data,
+               TCMAccessMode mode) final;
+  void WriteTCM(uint32_t addr, size_t size, const char* data,
+                TCMAccessMode mode) final;
+  uint64_t GetCycleCount() final;
+  void Step(uint64_t cycles) final;
+  void SetIdleSkip(bool idle_skip) final;
+  std::future<RunStatus> RunAsync(uint32_t start_addr,
+                                  uint64_t timeout) final;
+  void SetTerminationCallback(TerminationCallback callback) final;
+  void Cancel() final;
+  bool SaveCheckpoint(const char* path) final;
+  bool RestoreCheckpoint(const char* path) final;
+  bool MapExternalMemory(uint32_t addr, size_t size) final;
+  bool FillExternalMemory(uint32_t addr, size_t size, uint8_t value) final;
+  bool WriteExternalMemory(uint32_t addr, size_t size,
+                           const char* data) final;
+  bool ReadExternalMemory(uint32_t addr, size_t size, char* data) final;
+  char* MapTCM(uint32_t addr, size_t size) final;
+  bool MapTCMBuffer(uint32_t addr, size_t size, char* buffer) final;
+  void UnmapTCM(char* view) final;
+  void SetDoorbellCallback(DoorbellCallback callback) final;
+  void SetIrq(bool irq) final;
+  bool WaitForDoorbell(uint64_t timeout) final;
+  CoralNPUPerfCounters ReadPerfCounters() final;
+  CoralNPUMailbox ReadMailboxSnapshot() final;
+  std::future<RunStatus> RunAsync(uint32_t start_addr, uint64_t timeout,
+                                  RunMode mode) final;
 
  private:
+  struct TcmView {
+    uint32_t addr;
+    size_t size;
+    char* data;
+    // Set when the simulator allocated `data` rather than the caller.
+    std::unique_ptr<char[]> owned;
+    // The TCM contents as of the last flush or refresh. Where `data`
+    // differs, the host has written the view since.
+    std::unique_ptr<char[]> synced;
+  };
+
+  // Cycles simulated per lock hold by an asynchronous run. Host calls made
+  // during the run are serviced between slices.
+  static constexpr int kRunSliceCycles = 256;
+  // Granularity at which views are compared with `synced` when flushed.
+  static constexpr size_t kViewChunkBytes = 64;
+
+  // mutex_ held for a host call. Destruction unlocks it through
+  // UnlockAndNotify.
+  class HostLock {
+   public:
+    explicit HostLock(CoreMiniAxiSimulator* simulator);
+    ~HostLock() { simulator_->UnlockAndNotify(&lock_); }
+    std::unique_lock<std::mutex>& get() { return lock_; }
+
+   private:
+    CoreMiniAxiSimulator* simulator_;
+    std::unique_lock<std::mutex> lock_;
+  };
+
+  // Takes mutex_, making an asynchronous run yield to the caller at the end
+  // of its current slice.
+  HostLock LockForHost() { return HostLock(this); }
+  // Releases mutex_, then runs the doorbell callback for the doorbells rung
+  // while it was held, so that the callback may call back into the simulator.
+  void UnlockAndNotify(std::unique_lock<std::mutex>* lock);
+  // Requires mutex_.
+  bool RunInProgress() const { return running_; }
+  RunStatus RunLoop(uint64_t timeout, RunMode mode);
+  // Copy the chunks of the views the host has written into the TCMs, and
+  // the TCMs back out into the views.
+  void FlushTcmView(TcmView& view);
+  void FlushTcmViews();
+  void RefreshTcmViews();
+  // Keep host TCM accesses consistent with the views overlapping them: a
+  // write is copied into the views as already synced, and a read is patched
+  // with the bytes the host has written to the views but not yet flushed.
+  void WriteTcmViews(uint32_t addr, size_t size, const char* data);
+  void ReadTcmViews(uint32_t addr, size_t size, char* data);
+  // Called with mutex_ held by whichever thread is stepping the core. Queues
+  // the callback for UnlockAndNotify.
+  void OnDoorbell(uint32_t value);
+
   VerilatedContext context_;
   CoreMiniAxiWrapper wrapper_;
+  // Atomic as ReadTCM/WriteTCM read it before taking mutex_.
+  std::atomic<TCMAccessMode> tcm_access_mode_{TCMAccessMode::kAxi};
 
-  AxiWResp WriteCallback(const AxiAddr&, const AxiWData&);
-  AxiRData ReadCallback(const AxiAddr&);
+  // Guards wrapper_ between the host and the asynchronous run thread.
+  std::mutex mutex_;
+  std::atomic<int> host_waiting_{0};
+  std::atomic<bool> cancel_{false};
+  // Whether an asynchronous run is in progress. Guarded by mutex_.
+  bool running_ = false;
+  // Serializes RunAsync and the destructor, the only users of run_thread_.
+  // Taken before mutex_, never while holding it.
+  std::mutex run_mutex_;
+  std::thread run_thread_;
+  // Guarded by mutex_.
+  TerminationCallback termination_callback_;
+  std::vector<TcmView> tcm_views_;
+  DoorbellCallback doorbell_callback_;
+  // Doorbell values awaiting the callback. Guarded by mutex_.
+  std::vector<uint32_t> pending_doorbells_;
+  // doorbell_count() at the last SetIrq(true); WaitForDoorbell waits for it
+  // to change. Guarded by mutex_.
+  uint64_t irq_doorbell_count_ = 0;
+  // Signalled on every doorbell and when an asynchronous run ends. Waited on
+  // with mutex_ held.
+  std::condition_variable doorbell_cv_;
+  // Threads blocked in WaitForDoorbell during an asynchronous run. Guarded by
+  // mutex_.
+  int doorbell_waiters_ = 0;
 };
 
 void CoreMiniAxiSimulator::ReadTCM(uint32_t addr, size_t size, char* data) {
-  std::vector<uint8_t> read_result = wrapper_.Read(addr, size);
-  memcpy(data, read_result.data(), size);
+  ReadTCM(addr, size, data, tcm_access_mode_);
+}
+
+void CoreMiniAxiSimulator::ReadTCM(uint32_t addr, size_t size, char* data,
+                                   TCMAccessMode mode) {
+  auto lock = LockForHost();
+  auto dest = absl::MakeSpan(reinterpret_cast<uint8_t*>(data), size);
+  if (wrapper_.external_memory().Read(addr, dest)) {
+    return;
+  }
+  if (mode != TCMAccessMode::kBackdoor || !wrapper_.BackdoorRead(addr, dest)) {
+    wrapper_.Read(addr, dest);
+  }
+  ReadTcmViews(addr, size, data);
 }
 
 const CoralNPUMailbox& CoreMiniAxiSimulator::ReadMailbox(void) {
@@ -60,60 +185,402 @@ const CoralNPUMailbox& CoreMiniAxiSimulator::ReadMailbox(void) {
 
 void CoreMiniAxiSimulator::WriteTCM(uint32_t addr, size_t size,
                                     const char* data) {
-  wrapper_.Write(addr, size, data);
+  WriteTCM(addr, size, data, tcm_access_mode_);
+}
+
+void CoreMiniAxiSimulator::WriteTCM(uint32_t addr, size_t size,
+                                    const char* data, TCMAccessMode mode) {
+  auto lock = LockForHost();
+  auto src = absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(data), size);
+  if (wrapper_.external_memory().Write(addr, src)) {
+    return;
+  }
+  if (mode != TCMAccessMode::kBackdoor || !wrapper_.BackdoorWrite(addr, src)) {
+    wrapper_.Write(addr, src);
+  }
+  WriteTcmViews(addr, size, data);
+}
+
+void CoreMiniAxiSimulator::SetTCMAccessMode(TCMAccessMode mode) {
+  tcm_access_mode_ = mode;
+}
+
+uint64_t CoreMiniAxiSimulator::GetCycleCount() {
+  auto lock = LockForHost();
+  return wrapper_.cycles();
 }
 
 void CoreMiniAxiSimulator::WriteMailbox(const CoralNPUMailbox& mailbox) {
+  auto lock = LockForHost();
   wrapper_.WriteMailbox(mailbox);
 }
 
 void CoreMiniAxiSimulator::Run(uint32_t start_addr) {
-  wrapper_.WriteWord(0x30004, start_addr);
-  wrapper_.WriteWord(0x30000, 1u);
-  wrapper_.WriteWord(0x30000, 0u);
+  auto lock = LockForHost();
+  FlushTcmViews();
+  wrapper_.Start(start_addr);
 }
 
 bool CoreMiniAxiSimulator::WaitForTermination(int timeout = 10000) {
-  return wrapper_.WaitForTermination(timeout);
-}
-
-AxiWResp CoreMiniAxiSimulator::WriteCallback(const AxiAddr& addr,
-                                             const AxiWData& data) {
-  CoralNPUMailbox& mailbox = wrapper_.mailbox();
-  uint8_t* mailbox_data = reinterpret_cast<uint8_t*>(mailbox.message);
-  const uint8_t* write_data =
-      reinterpret_cast<const uint8_t*>(&data.write_data_bits_data[0]);
-  for (int i = 0; i < 16; i++) {
-    if (data.write_data_bits_strb & (1 << i)) {
-      mailbox_data[i] = write_data[i];
+  auto lock = LockForHost();
+  bool terminated = wrapper_.WaitForTermination(timeout);
+  RefreshTcmViews();
+  return terminated;
+}
+
+void CoreMiniAxiSimulator::Step(uint64_t cycles) {
+  auto lock = LockForHost();
+  wrapper_.StepCycles(cycles);
+}
+
+void CoreMiniAxiSimulator::SetIdleSkip(bool idle_skip) {
+  auto lock = LockForHost();
+  wrapper_.set_idle_skip(idle_skip);
+}
+
+std::future<RunStatus> CoreMiniAxiSimulator::RunAsync(uint32_t start_addr,
+                                                      uint64_t timeout) {
+  return RunAsync(start_addr, timeout, RunMode::kUntilWfi);
+}
+
+std::future<RunStatus> CoreMiniAxiSimulator::RunAsync(uint32_t start_addr,
+                                                      uint64_t timeout,
+                                                      RunMode mode) {
+  std::promise<RunStatus> promise;
+  std::future<RunStatus> result = promise.get_future();
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  {
+    auto lock = LockForHost();
+    if (RunInProgress()) {
+      promise.set_value(RunStatus::kBusy);
+      return result;
     }
   }
+  // The previous run has ended but its thread may still be in the
+  // termination callback, which can take mutex_.
+  if (run_thread_.joinable()) {
+    run_thread_.join();
+  }
+
+  TerminationCallback callback;
+  {
+    auto lock = LockForHost();
+    cancel_ = false;
+    running_ = true;
+    callback = termination_callback_;
+    FlushTcmViews();
+    wrapper_.Start(start_addr);
+  }
+  run_thread_ = std::thread(
+      [this, timeout, mode, callback = std::move(callback)](
+          std::promise<RunStatus> promise) {
+        RunStatus status = RunLoop(timeout, mode);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          RefreshTcmViews();
+          running_ = false;
+        }
+        doorbell_cv_.notify_all();
+        if (callback) {
+          callback(status);
+        }
+        promise.set_value(status);
+      },
+      std::move(promise));
+  return result;
+}
+
+void CoreMiniAxiSimulator::SetTerminationCallback(
+    TerminationCallback callback) {
+  auto lock = LockForHost();
+  termination_callback_ = std::move(callback);
+}
+
+void CoreMiniAxiSimulator::Cancel() { cancel_ = true; }
+
+bool CoreMiniAxiSimulator::SaveCheckpoint(const char* path) {
+  auto lock = LockForHost();
+  if (RunInProgress()) {
+    return false;
+  }
+  return wrapper_.SaveCheckpoint(path);
+}
+
+bool CoreMiniAxiSimulator::RestoreCheckpoint(const char* path) {
+  auto lock = LockForHost();
+  if (RunInProgress()) {
+    return false;
+  }
+  if (!wrapper_.RestoreCheckpoint(path)) {
+    return false;
+  }
+  RefreshTcmViews();
+  return true;
+}
+
+bool CoreMiniAxiSimulator::MapExternalMemory(uint32_t addr, size_t size) {
+  auto lock = LockForHost();
+  return wrapper_.external_memory().Map(addr, size);
+}
+
+bool CoreMiniAxiSimulator::FillExternalMemory(uint32_t addr, size_t size,
+                                              uint8_t value) {
+  auto lock = LockForHost();
+  return wrapper_.external_memory().Fill(addr, size, value);
+}
+
+bool CoreMiniAxiSimulator::WriteExternalMemory(uint32_t addr, size_t size,
+                                               const char* data) {
+  auto lock = LockForHost();
+  return wrapper_.external_memory().Write(
+      addr,
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(data), size));
+}
 
-  AxiWResp resp;
-  resp.write_resp_bits_id = addr.addr_bits_id;
-  resp.write_resp_bits_resp = 0;
-  return resp;
+bool CoreMiniAxiSimulator::ReadExternalMemory(uint32_t addr, size_t size,
+                                              char* data) {
+  auto lock = LockForHost();
+  return wrapper_.external_memory().Read(
+      addr, absl::MakeSpan(reinterpret_cast<uint8_t*>(data), size));
 }
 
-AxiRData CoreMiniAxiSimulator::ReadCallback(const AxiAddr& addr) {
-  const CoralNPUMailbox& mailbox = wrapper_.mailbox();
-  const uint8_t* mailbox_data =
-      reinterpret_cast<const uint8_t*>(mailbox.message);
-  AxiRData data;
-  uint8_t* read_data =
-      reinterpret_cast<uint8_t*>(&(data.read_data_bits_data[0]));
-  for (int i = 0; i < 16; i++) {
-    read_data[i] = mailbox_data[i];
+char* CoreMiniAxiSimulator::MapTCM(uint32_t addr, size_t size) {
+  auto lock = LockForHost();
+  if (size == 0 || !wrapper_.InTcm(addr, size)) {
+    return nullptr;
   }
+  TcmView view{addr, size, nullptr, std::make_unique<char[]>(size),
+               std::make_unique<char[]>(size)};
+  view.data = view.owned.get();
+  wrapper_.BackdoorRead(addr, size, view.synced.get());
+  memcpy(view.data, view.synced.get(), size);
+  tcm_views_.push_back(std::move(view));
+  return tcm_views_.back().data;
+}
 
-  data.read_data_bits_id = addr.addr_bits_id;
-  data.read_data_bits_resp = 0;
-  data.read_data_bits_last = 1;
+bool CoreMiniAxiSimulator::MapTCMBuffer(uint32_t addr, size_t size,
+                                        char* buffer) {
+  auto lock = LockForHost();
+  if (buffer == nullptr || size == 0 || !wrapper_.InTcm(addr, size)) {
+    return false;
+  }
+  TcmView view{addr, size, buffer, nullptr, std::make_unique<char[]>(size)};
+  wrapper_.BackdoorRead(addr, size, view.synced.get());
+  memcpy(buffer, view.synced.get(), size);
+  tcm_views_.push_back(std::move(view));
+  return true;
+}
 
-  return data;
+void CoreMiniAxiSimulator::UnmapTCM(char* view) {
+  auto lock = LockForHost();
+  auto it = std::find_if(
+      tcm_views_.begin(), tcm_views_.end(),
+      [view](const TcmView& v) { return v.data == view; });
+  if (it == tcm_views_.end()) {
+    return;
+  }
+  FlushTcmView(*it);
+  tcm_views_.erase(it);
+}
+
+void CoreMiniAxiSimulator::FlushTcmView(TcmView& view) {
+  auto chunk_dirty = [&view](size_t offset) {
+    size_t bytes = std::min(kViewChunkBytes, view.size - offset);
+    return memcmp(view.data + offset, view.synced.get() + offset, bytes) != 0;
+  };
+  size_t offset = 0;
+  while (offset < view.size) {
+    if (!chunk_dirty(offset)) {
+      offset += kViewChunkBytes;
+      continue;
+    }
+    // Write each run of dirty chunks with one backdoor access.
+    const size_t begin = offset;
+    do {
+      offset += kViewChunkBytes;
+    } while (offset < view.size && chunk_dirty(offset));
+    const size_t end = std::min(offset, view.size);
+    wrapper_.BackdoorWrite(view.addr + begin, end - begin, view.data + begin);
+    memcpy(view.synced.get() + begin, view.data + begin, end - begin);
+  }
+}
+
+void CoreMiniAxiSimulator::FlushTcmViews() {
+  for (TcmView& view : tcm_views_) {
+    FlushTcmView(view);
+  }
+}
+
+void CoreMiniAxiSimulator::RefreshTcmViews() {
+  for (TcmView& view : tcm_views_) {
+    wrapper_.BackdoorRead(view.addr, view.size, view.synced.get());
+    memcpy(view.data, view.synced.get(), view.size);
+  }
+}
+
+void CoreMiniAxiSimulator::WriteTcmViews(uint32_t addr, size_t size,
+                                         const char* data) {
+  const uint64_t end = static_cast<uint64_t>(addr) + size;
+  for (TcmView& view : tcm_views_) {
+    const uint64_t begin = std::max<uint64_t>(addr, view.addr);
+    const uint64_t limit = std::min<uint64_t>(end, view.addr + view.size);
+    if (begin < limit) {
+      memcpy(view.data + (begin - view.addr), data + (begin - addr),
+             limit - begin);
+      memcpy(view.synced.get() + (begin - view.addr), data + (begin - addr),
+             limit - begin);
+    }
+  }
+}
+
+void CoreMiniAxiSimulator::ReadTcmViews(uint32_t addr, size_t size,
+                                        char* data) {
+  const uint64_t end = static_cast<uint64_t>(addr) + size;
+  for (const TcmView& view : tcm_views_) {
+    const uint64_t begin = std::max<uint64_t>(addr, view.addr);
+    const uint64_t limit = std::min<uint64_t>(end, view.addr + view.size);
+    for (uint64_t a = begin; a < limit; a++) {
+      const size_t offset = a - view.addr;
+      if (view.data[offset] != view.synced[offset]) {
+        data[a - addr] = view.data[offset];
+      }
+    }
+  }
+}
+
+void CoreMiniAxiSimulator::SetDoorbellCallback(DoorbellCallback callback) {
+  auto lock = LockForHost();
+  doorbell_callback_ = std::move(callback);
+}
+
+void CoreMiniAxiSimulator::SetIrq(bool irq) {
+  auto lock = LockForHost();
+  if (irq) {
+    irq_doorbell_count_ = wrapper_.doorbell_count();
+    // The job posted in the views must be in the TCM when the core wakes.
+    if (!RunInProgress()) {
+      FlushTcmViews();
+    }
+  }
+  wrapper_.SetIrq(irq);
+}
+
+bool CoreMiniAxiSimulator::WaitForDoorbell(uint64_t timeout) {
+  auto lock = LockForHost();
+  // Counting from SetIrq(true) rather than from this call catches a doorbell
+  // that rang in between.
+  const uint64_t start_count = irq_doorbell_count_;
+  if (RunInProgress()) {
+    if (wrapper_.doorbell_count() != start_count) {
+      return true;
+    }
+    doorbell_waiters_++;
+    doorbell_cv_.wait(lock.get(), [this, start_count]() {
+      return wrapper_.doorbell_count() != start_count || !running_;
+    });
+    if (wrapper_.doorbell_count() != start_count) {
+      // OnDoorbell moved this waiter into host_waiting_.
+      host_waiting_--;
+      return true;
+    }
+    doorbell_waiters_--;
+    return false;
+  }
+  bool rang = wrapper_.doorbell_count() != start_count ||
+              wrapper_.WaitForDoorbell(timeout, start_count);
+  if (rang) {
+    RefreshTcmViews();
+  }
+  return rang;
+}
+
+CoralNPUPerfCounters CoreMiniAxiSimulator::ReadPerfCounters() {
+  auto lock = LockForHost();
+  return wrapper_.ReadPerfCounters();
+}
+
+CoralNPUMailbox CoreMiniAxiSimulator::ReadMailboxSnapshot() {
+  auto lock = LockForHost();
+  return wrapper_.ReadMailbox();
+}
+
+void CoreMiniAxiSimulator::OnDoorbell(uint32_t value) {
+  if (doorbell_callback_) {
+    pending_doorbells_.push_back(value);
+  }
+  // Have the run thread yield, as for any host call, until the woken waiters
+  // have retaken the lock.
+  host_waiting_ += doorbell_waiters_;
+  doorbell_waiters_ = 0;
+  doorbell_cv_.notify_all();
+}
+
+CoreMiniAxiSimulator::HostLock::HostLock(CoreMiniAxiSimulator* simulator)
+    : simulator_(simulator) {
+  simulator_->host_waiting_++;
+  lock_ = std::unique_lock<std::mutex>(simulator_->mutex_);
+  simulator_->host_waiting_--;
+}
+
+void CoreMiniAxiSimulator::UnlockAndNotify(
+    std::unique_lock<std::mutex>* lock) {
+  if (pending_doorbells_.empty()) {
+    lock->unlock();
+    return;
+  }
+  std::vector<uint32_t> doorbells;
+  doorbells.swap(pending_doorbells_);
+  DoorbellCallback callback = doorbell_callback_;
+  lock->unlock();
+  if (callback) {
+    for (uint32_t value : doorbells) {
+      callback(value);
+    }
+  }
+}
+
+RunStatus CoreMiniAxiSimulator::RunLoop(uint64_t timeout, RunMode mode) {
+  uint64_t elapsed = 0;
+  while (true) {
+    // Let any host call queued on the lock go first.
+    while (host_waiting_ > 0) {
+      std::this_thread::yield();
+    }
+    if (cancel_) {
+      return RunStatus::kCancelled;
+    }
+    if (timeout != 0 && elapsed >= timeout) {
+      return RunStatus::kTimeout;
+    }
+    int slice = kRunSliceCycles;
+    if (timeout != 0 && timeout - elapsed < kRunSliceCycles) {
+      slice = static_cast<int>(timeout - elapsed);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t start_cycles = wrapper_.cycles();
+    bool terminated;
+    if (mode == RunMode::kResident) {
+      // StepCycles, unlike WaitForTermination, lets idle skip fast-forward
+      // the core while it is parked in WFI.
+      wrapper_.StepCycles(slice);
+      terminated = wrapper_.halted();
+    } else {
+      terminated = wrapper_.WaitForTermination(slice);
+    }
+    elapsed += wrapper_.cycles() - start_cycles;
+    UnlockAndNotify(&lock);
+    if (terminated) {
+      return RunStatus::kTerminated;
+    }
+  }
 }
 
 // static
 CoralNPUSimulator* CoralNPUSimulator::Create() {
   return new CoreMiniAxiSimulator();
 }
+
+extern "C" CoralNPUSimulator* CoralNPUSimulatorCreate() {
+  return CoralNPUSimulator::Create();
+}
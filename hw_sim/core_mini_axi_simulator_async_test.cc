@@ -0,0 +1,116 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Exercises Step(), RunAsync(), the termination callback and Cancel() on
+// mailbox_example.elf, with TCM traffic issued while the run is in progress.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+int main() {
+  std::unique_ptr<CoralNPUSimulator> simulator(CoralNPUSimulator::Create());
+
+  std::optional<uint32_t> start_pc =
+      LoadElfIntoSimulator(simulator.get(), "hw_sim/mailbox_example.elf");
+  if (!start_pc) {
+    return 1;
+  }
+
+  // Step advances exactly the requested number of cycles.
+  uint64_t start_cycles = simulator->GetCycleCount();
+  simulator->Step(100);
+  if (simulator->GetCycleCount() - start_cycles != 100) {
+    std::cout << "Step(100) advanced "
+              << simulator->GetCycleCount() - start_cycles << " cycles"
+              << std::endl;
+    return 1;
+  }
+
+  std::atomic<int> callbacks{0};
+  simulator->SetTerminationCallback([&callbacks](RunStatus status) {
+    if (status == RunStatus::kTerminated) {
+      callbacks++;
+    }
+  });
+
+  // Stage the next input in DTCM (heap, unused by the program) while it runs.
+  std::vector<uint8_t> staged(4096);
+  for (size_t i = 0; i < staged.size(); i++) {
+    staged[i] = static_cast<uint8_t>(i * 7);
+  }
+  constexpr uint32_t kStagingAddr = 0x14000;
+  std::future<RunStatus> run = simulator->RunAsync(*start_pc, 100000);
+  simulator->WriteTCM(kStagingAddr, staged.size(),
+                      reinterpret_cast<const char*>(staged.data()));
+  RunStatus status = run.get();
+  if (status != RunStatus::kTerminated || callbacks != 1) {
+    std::cout << "Run did not terminate" << std::endl;
+    return 1;
+  }
+  CoralNPUMailbox mailbox = simulator->ReadMailbox();
+  if (mailbox.message[0] != 0xDEADBEEF || mailbox.message[1] != 0xDEADBEEF) {
+    std::cout << "Unexpected mailbox 0x" << std::hex << mailbox.message[0]
+              << " 0x" << mailbox.message[1] << std::endl;
+    return 1;
+  }
+  CoralNPUPerfCounters perf = simulator->ReadPerfCounters();
+  if (perf.cycles != simulator->GetCycleCount() ||
+      perf.active_cycles + perf.wfi_cycles + perf.halted_cycles !=
+          perf.cycles ||
+      perf.instructions_dispatched() == 0 || perf.master_write.beats < 2 ||
+      perf.slave_write.bytes < staged.size()) {
+    std::cout << "Unexpected performance counters" << std::endl;
+    return 1;
+  }
+  std::vector<uint8_t> readback(staged.size());
+  simulator->ReadTCM(kStagingAddr, readback.size(),
+                     reinterpret_cast<char*>(readback.data()));
+  if (readback != staged) {
+    std::cout << "Staged data mismatch" << std::endl;
+    return 1;
+  }
+
+  // A cancelled run ends promptly with either status, never a timeout. The
+  // program is thousands of cycles long, so a second run requested straight
+  // away finds the first still in progress.
+  run = simulator->RunAsync(*start_pc, 0);
+  std::future<RunStatus> busy = simulator->RunAsync(*start_pc, 0);
+  if (busy.wait_for(std::chrono::seconds(0)) != std::future_status::ready ||
+      busy.get() != RunStatus::kBusy) {
+    std::cout << "Second RunAsync did not report kBusy" << std::endl;
+    return 1;
+  }
+  simulator->Cancel();
+  if (run.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+    std::cout << "Cancel did not end the run" << std::endl;
+    return 1;
+  }
+  status = run.get();
+  if (status != RunStatus::kCancelled && status != RunStatus::kTerminated) {
+    std::cout << "Unexpected status after Cancel" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Serves jobs through doorbell_example.elf with the core stepped by the host,
+// by an asynchronous run that ends in WFI and by a resident one that does
+// not. The doorbell callback reads the mailbox back, which requires it to run
+// outside the simulator lock.
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+namespace {
+
+// DTCM heap, unused by the firmware.
+constexpr uint32_t kInputAddr = 0x14000;
+constexpr int kInputWords = 16;
+constexpr uint64_t kJobTimeoutCycles = 100000;
+
+struct Doorbell {
+  uint32_t value;
+  uint32_t sum;
+};
+
+// Posts job `job` and raises the interrupt. Returns the expected sum.
+uint32_t PostJob(CoralNPUSimulator* simulator, int job) {
+  std::vector<uint32_t> input(kInputWords);
+  uint32_t sum = 0;
+  for (int i = 0; i < kInputWords; i++) {
+    input[i] = job * 100 + i;
+    sum += input[i];
+  }
+  simulator->WriteTCM(kInputAddr, input.size() * sizeof(uint32_t),
+                      reinterpret_cast<const char*>(input.data()));
+  CoralNPUMailbox mailbox;
+  mailbox.message[0] = kInputAddr;
+  mailbox.message[1] = kInputWords;
+  simulator->WriteMailbox(mailbox);
+  simulator->SetIrq(true);
+  return sum;
+}
+
+}  // namespace
+
+int main() {
+  std::unique_ptr<CoralNPUSimulator> simulator(CoralNPUSimulator::Create());
+  simulator->SetTCMAccessMode(TCMAccessMode::kBackdoor);
+  std::optional<uint32_t> start_pc =
+      LoadElfIntoSimulator(simulator.get(), "hw_sim/doorbell_example.elf");
+  if (!start_pc) {
+    return 1;
+  }
+
+  std::mutex doorbells_mutex;
+  std::vector<Doorbell> doorbells;
+  CoralNPUSimulator* sim = simulator.get();
+  simulator->SetDoorbellCallback([&, sim](uint32_t value) {
+    Doorbell doorbell{value, sim->ReadMailboxSnapshot().message[2]};
+    std::lock_guard<std::mutex> lock(doorbells_mutex);
+    doorbells.push_back(doorbell);
+  });
+
+  // Host-stepped: the firmware parks in WFI, and each job is answered while
+  // the host steps the core. The Step lets the doorbell ring before
+  // WaitForDoorbell is called, which must still report it.
+  simulator->Run(*start_pc);
+  if (!simulator->WaitForTermination(kJobTimeoutCycles)) {
+    std::cout << "Firmware did not reach WFI" << std::endl;
+    return 1;
+  }
+  for (int job = 1; job <= 3; job++) {
+    uint32_t expected = PostJob(simulator.get(), job);
+    simulator->Step(kJobTimeoutCycles / 10);
+    if (!simulator->WaitForDoorbell(kJobTimeoutCycles)) {
+      std::cout << "Job " << job << " doorbell lost" << std::endl;
+      return 1;
+    }
+    if (simulator->ReadMailbox().message[2] != expected ||
+        doorbells.size() != static_cast<size_t>(job) ||
+        doorbells.back().value != static_cast<uint32_t>(job) ||
+        doorbells.back().sum != expected) {
+      std::cout << "Job " << job << " answered wrongly" << std::endl;
+      return 1;
+    }
+  }
+
+  // Asynchronous: the restarted firmware takes the job raised before the
+  // run, rings the doorbell from the run thread, and the run ends in WFI.
+  doorbells.clear();
+  uint32_t expected = PostJob(simulator.get(), 4);
+  std::future<RunStatus> run = simulator->RunAsync(*start_pc, 0);
+  if (!simulator->WaitForDoorbell(kJobTimeoutCycles)) {
+    std::cout << "Asynchronous doorbell not seen" << std::endl;
+    return 1;
+  }
+  if (run.wait_for(std::chrono::seconds(10)) != std::future_status::ready ||
+      run.get() != RunStatus::kTerminated) {
+    std::cout << "Asynchronous run did not end in WFI" << std::endl;
+    return 1;
+  }
+  {
+    std::lock_guard<std::mutex> lock(doorbells_mutex);
+    if (doorbells.size() != 1 || doorbells[0].value != 1 ||
+        doorbells[0].sum != expected) {
+      std::cout << "Asynchronous job answered wrongly" << std::endl;
+      return 1;
+    }
+  }
+
+  // Resident: one asynchronous run serves several jobs, the firmware parking
+  // in WFI between them, until it is cancelled.
+  {
+    std::lock_guard<std::mutex> lock(doorbells_mutex);
+    doorbells.clear();
+  }
+  run = simulator->RunAsync(*start_pc, 0, RunMode::kResident);
+  for (int job = 1; job <= 3; job++) {
+    expected = PostJob(simulator.get(), job);
+    if (!simulator->WaitForDoorbell(kJobTimeoutCycles)) {
+      std::cout << "Resident job " << job << " doorbell lost" << std::endl;
+      return 1;
+    }
+    if (simulator->ReadMailboxSnapshot().message[2] != expected) {
+      std::cout << "Resident job " << job << " answered wrongly" << std::endl;
+      return 1;
+    }
+  }
+  if (run.wait_for(std::chrono::milliseconds(100)) !=
+      std::future_status::timeout) {
+    std::cout << "Resident run ended in WFI" << std::endl;
+    return 1;
+  }
+  simulator->Cancel();
+  if (run.get() != RunStatus::kCancelled) {
+    std::cout << "Resident run not cancelled" << std::endl;
+    return 1;
+  }
+  {
+    std::lock_guard<std::mutex> lock(doorbells_mutex);
+    if (doorbells.size() != 3 || doorbells.back().value != 3) {
+      std::cout << "Resident doorbells missing" << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Passed" << std::endl;
+  return 0;
+}
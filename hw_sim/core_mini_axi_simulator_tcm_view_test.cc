@@ -0,0 +1,116 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that a mapped TCM view written by the host reaches the TCM when the
+// core runs and on unmap, as seen over the AXI slave port.
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+namespace {
+
+// DTCM heap, unused by mailbox_example.
+constexpr uint32_t kViewAddr = 0x14000;
+constexpr size_t kViewBytes = 4096;
+
+bool ReadBackMatches(CoralNPUSimulator* simulator, const char* expected) {
+  std::vector<char> readback(kViewBytes);
+  simulator->ReadTCM(kViewAddr, readback.size(), readback.data(),
+                     TCMAccessMode::kAxi);
+  return memcmp(readback.data(), expected, kViewBytes) == 0;
+}
+
+}  // namespace
+
+int main() {
+  std::unique_ptr<CoralNPUSimulator> simulator(CoralNPUSimulator::Create());
+
+  std::optional<uint32_t> start_pc =
+      LoadElfIntoSimulator(simulator.get(), "hw_sim/mailbox_example.elf");
+  if (!start_pc) {
+    return 1;
+  }
+
+  if (simulator->MapTCM(0x30000, 16) != nullptr ||
+      simulator->MapTCM(0x17ff0, 32) != nullptr) {
+    std::cout << "Mapped a range outside the TCMs" << std::endl;
+    return 1;
+  }
+
+  char* view = simulator->MapTCM(kViewAddr, kViewBytes);
+  if (view == nullptr) {
+    std::cout << "MapTCM failed" << std::endl;
+    return 1;
+  }
+  std::vector<char> expected(kViewBytes);
+  for (size_t i = 0; i < kViewBytes; i++) {
+    expected[i] = static_cast<char>(i * 13);
+  }
+  memcpy(view, expected.data(), kViewBytes);
+  simulator->Run(*start_pc);
+  if (!simulator->WaitForTermination(100000)) {
+    std::cout << "Run did not terminate" << std::endl;
+    return 1;
+  }
+  // Had the view not been flushed, the refresh at termination would have
+  // replaced it with the old TCM contents.
+  if (!ReadBackMatches(simulator.get(), expected.data())) {
+    std::cout << "View not flushed before the run" << std::endl;
+    return 1;
+  }
+
+  for (size_t i = 0; i < kViewBytes; i++) {
+    expected[i] = static_cast<char>(~expected[i]);
+  }
+  memcpy(view, expected.data(), kViewBytes);
+  simulator->UnmapTCM(view);
+  if (!ReadBackMatches(simulator.get(), expected.data())) {
+    std::cout << "View not flushed on unmap" << std::endl;
+    return 1;
+  }
+
+  // A host write into a mapped range updates the view, so the next flush
+  // does not undo it, and a host read sees the view's pending contents.
+  view = simulator->MapTCM(kViewAddr, kViewBytes);
+  memset(view, 0x11, kViewBytes);
+  const std::vector<char> patch(64, 0x22);
+  simulator->WriteTCM(kViewAddr + 128, patch.size(), patch.data(),
+                      TCMAccessMode::kBackdoor);
+  expected.assign(kViewBytes, 0x11);
+  memcpy(&expected[128], patch.data(), patch.size());
+  if (memcmp(view, expected.data(), kViewBytes) != 0) {
+    std::cout << "WriteTCM did not update the view" << std::endl;
+    return 1;
+  }
+  if (!ReadBackMatches(simulator.get(), expected.data())) {
+    std::cout << "ReadTCM did not see the view" << std::endl;
+    return 1;
+  }
+  simulator->Step(1);
+  simulator->UnmapTCM(view);
+  if (!ReadBackMatches(simulator.get(), expected.data())) {
+    std::cout << "Flushing the view undid WriteTCM" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Passed" << std::endl;
+  return 0;
+}
@@ -15,24 +15,68 @@
 #ifndef HW_SIM_CORE_MINI_AXI_WRAPPER_H_
 #define HW_SIM_CORE_MINI_AXI_WRAPPER_H_
 
+#include <svdpi.h>
+
 #include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "hw_sim/external_memory.h"
 #include "hw_sim/hw_primitives.h"
 #include "hw_sim/mailbox.h"
+#include "hw_sim/perf_counters.h"
 
-#ifdef ENABLE_RVV
+#if defined(ENABLE_RVV) && defined(ENABLE_HIGHMEM)
+#include "VRvvCoreMiniHighmemAxi.h"
+#include "VRvvCoreMiniHighmemAxi__Dpi.h"
+using CoreMiniAxiModel = VRvvCoreMiniHighmemAxi;
+constexpr char kCoreMiniAxiTopName[] = "RvvCoreMiniHighmemAxi";
+#elif defined(ENABLE_RVV)
 #include "VRvvCoreMiniAxi.h"
+#include "VRvvCoreMiniAxi__Dpi.h"
+using CoreMiniAxiModel = VRvvCoreMiniAxi;
+constexpr char kCoreMiniAxiTopName[] = "RvvCoreMiniAxi";
 #else
 #include "VCoreMiniAxi.h"
+#include "VCoreMiniAxi__Dpi.h"
+using CoreMiniAxiModel = VCoreMiniAxi;
+constexpr char kCoreMiniAxiTopName[] = "CoreMiniAxi";
+#endif
+
+// After the model's __Dpi.h, which declares the SRAM DPI functions.
+#include "hw_sim/tcm_backdoor.h"
+
+// Threads the model was verilated with (--threads); set by the
+// *_threads<N> build variants.
+#ifndef VERILATOR_THREADS
+#define VERILATOR_THREADS 1
+#endif
+
+// Locations of the TCMs and the CSR block (MemoryRegions in Parameters.scala).
+#ifdef ENABLE_HIGHMEM
+constexpr uint32_t kItcmAddr = 0x000000;
+constexpr uint32_t kItcmSizeBytes = 0x100000;
+constexpr uint32_t kDtcmAddr = 0x100000;
+constexpr uint32_t kDtcmSizeBytes = 0x100000;
+constexpr uint32_t kCsrAddr = 0x200000;
+#else
+constexpr uint32_t kItcmAddr = 0x00000;
+constexpr uint32_t kItcmSizeBytes = 0x2000;
+constexpr uint32_t kDtcmAddr = 0x10000;
+constexpr uint32_t kDtcmSizeBytes = 0x8000;
+constexpr uint32_t kCsrAddr = 0x30000;
 #endif
 
 class CoreMiniAxiWrapper {
  public:
   explicit CoreMiniAxiWrapper(VerilatedContext* context)
       : context_(context),
-        core_(context, "core"),
+        core_(WithModelThreads(context), "core"),
         clock_(context, &core_.io_aclk, &core_),
         slave_write_driver_(&clock_, &core_.io_axi_slave_write_addr_valid,
                             &core_.io_axi_slave_write_addr_bits_addr,
@@ -112,8 +156,21 @@ class CoreMiniAxiWrapper {
                              &core_.io_axi_master_write_resp_bits_id,
                              &core_.io_axi_master_write_resp_bits_resp,
                              &core_.io_axi_master_write_resp_ready),
+        itcm_backdoor_(
+            std::string("core.") + kCoreMiniAxiTopName + ".itcm", kItcmAddr,
+            kItcmSizeBytes),
+        dtcm_backdoor_(
+            std::string("core.") + kCoreMiniAxiTopName + ".dtcm", kDtcmAddr,
+            kDtcmSizeBytes),
         halted_(&core_.io_halted),
-        wfi_(&core_.io_wfi) {}
+        wfi_(&core_.io_wfi),
+        external_memory_(kExternalMemoryAddr, kExternalMemorySizeBytes) {
+    RegisterReadCallback(
+        [this](const AxiAddr& addr) { return DeviceRead(addr); });
+    RegisterWriteCallback([this](const AxiAddr& addr, const AxiWData& data) {
+      return DeviceWrite(addr, data);
+    });
+  }
   ~CoreMiniAxiWrapper() = default;
 
   void Reset() {
@@ -125,7 +182,91 @@ class CoreMiniAxiWrapper {
     context_->timeInc(1);
   }
 
-  void Step() { clock_.Step(); }
+  void Step() {
+    clock_.Step();
+    cycles_++;
+    CountCycles(1);
+    perf_.dispatch_fires[0] += core_.io_debug_dispatch_0_instFire;
+    perf_.dispatch_fires[1] += core_.io_debug_dispatch_1_instFire;
+    perf_.dispatch_fires[2] += core_.io_debug_dispatch_2_instFire;
+    perf_.dispatch_fires[3] += core_.io_debug_dispatch_3_instFire;
+    if (doorbell_pending_) {
+      RingDoorbell();
+    }
+    quiescent_cycles_ = Quiescent() ? quiescent_cycles_ + 1 : 0;
+  }
+
+  // Advances `cycles` clock cycles. With idle skip enabled, once the design
+  // has been quiescent (see Quiescent()) for kIdleSettleCycles the remaining
+  // cycles are skipped without evaluating the model: nothing can wake the core
+  // until the host drives the slave port or raises an interrupt, neither of
+  // which can happen inside this call.
+  void StepCycles(uint64_t cycles) {
+    while (cycles > 0) {
+      if (idle_skip_ && quiescent_cycles_ >= kIdleSettleCycles) {
+        clock_.Skip(cycles);
+        cycles_ += cycles;
+        skipped_cycles_ += cycles;
+        CountCycles(cycles);
+        return;
+      }
+      Step();
+      cycles--;
+    }
+  }
+
+  // Enables fast-forwarding of quiescent stretches in StepCycles(). Skipped
+  // cycles still advance simulation time and cycles(), but the design's own
+  // counters (e.g. mcycle) do not see them.
+  void set_idle_skip(bool idle_skip) { idle_skip_ = idle_skip; }
+
+  // Sets the latency and throughput of the memory behind the master port.
+  void set_master_timing(const AxiMasterTiming& timing) {
+    master_read_driver_.set_timing(timing);
+    master_write_driver_.set_timing(timing);
+  }
+
+  // True when the core is in WFI or halted, no interrupt is being raised and
+  // neither the slave nor the master port has a transaction in progress.
+  bool Quiescent() const {
+    return ((*halted_) || (*wfi_)) && !core_.io_irq &&
+           slave_write_driver_.outstanding() == 0 &&
+           slave_read_driver_.outstanding() == 0 &&
+           master_read_driver_.idle() && master_write_driver_.idle();
+  }
+
+  // Drives the core's interrupt line. A core write to the mailbox doorbell
+  // word deasserts it again.
+  void SetIrq(bool irq) {
+    core_.io_irq = irq;
+    clock_.Eval();
+    quiescent_cycles_ = 0;
+  }
+
+  // Selects how the drivers are scheduled around model evaluation. See
+  // Clock::EvalMode; kPerObserver restores the original behaviour.
+  void set_eval_mode(Clock::EvalMode eval_mode) {
+    clock_.set_eval_mode(eval_mode);
+  }
+
+  // Number of clock cycles elapsed since construction, including skipped ones.
+  uint64_t cycles() const { return cycles_; }
+
+  bool halted() const { return *halted_; }
+
+  // Number of cycles in cycles() that were skipped rather than evaluated.
+  uint64_t skipped_cycles() const { return skipped_cycles_; }
+
+  // Snapshot of the performance counters. Cheap enough to take per job.
+  CoralNPUPerfCounters ReadPerfCounters() const {
+    CoralNPUPerfCounters perf = perf_;
+    perf.cycles = cycles_;
+    perf.slave_read = Traffic(slave_read_driver_.counters());
+    perf.slave_write = Traffic(slave_write_driver_.counters());
+    perf.master_read = Traffic(master_read_driver_.counters());
+    perf.master_write = Traffic(master_write_driver_.counters());
+    return perf;
+  }
 
   CoralNPUMailbox& mailbox() { return mailbox_; }
 
@@ -133,59 +274,207 @@ class CoreMiniAxiWrapper {
 
   const CoralNPUMailbox& ReadMailbox(void) { return mailbox_; }
 
+  ExternalMemory& external_memory() { return external_memory_; }
+
+  // Called, from Step(), with the value written each time the core writes
+  // the mailbox doorbell word (kCoralNPUDoorbellWord).
+  void SetDoorbellCallback(std::function<void(uint32_t value)> doorbell_cb) {
+    doorbell_cb_ = std::move(doorbell_cb);
+  }
+
+  // Number of times the core has rung the doorbell.
+  uint64_t doorbell_count() const { return doorbell_count_; }
+
   void WriteMailbox(const CoralNPUMailbox& mailbox) {
     for (int i = 0; i < 4; i++) {
       mailbox_.message[i] = mailbox.message[i];
     }
   }
 
+  // Sets how many slave-port bursts Write() and Read() keep in flight, each
+  // on its own AXI ID. 1 serializes transfers one 4 KiB chunk at a time.
+  void set_max_outstanding(int max_outstanding) {
+    assert(max_outstanding > 0 &&
+           max_outstanding <= static_cast<int>(kAxiMaxOutstanding));
+    max_outstanding_ = max_outstanding;
+  }
+
   void Write(uint32_t addr, uint32_t len, const char* data) {
-    auto write_data =
-        absl::Span<const uint8_t>(reinterpret_cast<const uint8_t*>(data), len);
-    while (write_data.size() > 0) {
-      uint32_t offset4096 = addr % 4096;
-      uint32_t remainder4096 = 4096 - offset4096;
-      uint32_t max_transaction_bytes = std::min(4096u, remainder4096);
-      uint32_t transaction_bytes = std::min(
-          static_cast<uint32_t>(write_data.size()), max_transaction_bytes);
-      absl::Span<const uint8_t> local_data =
-          write_data.subspan(0, transaction_bytes);
-
-      std::shared_ptr<bool> transaction =
-          slave_write_driver_.WriteTransaction(0, addr, local_data);
-      while (!(*transaction)) {
-        Step();
+    Write(addr, absl::Span<const uint8_t>(
+                    reinterpret_cast<const uint8_t*>(data), len));
+  }
+
+  // Writes `data` over the slave port. The bursts read straight from `data`.
+  void Write(uint32_t addr, absl::Span<const uint8_t> data) {
+    int in_flight = 0;
+    int next_id = 0;
+    while (data.size() > 0 || in_flight > 0) {
+      while (data.size() > 0 && in_flight < max_outstanding_) {
+        uint32_t transaction_bytes =
+            ChunkBytes(addr, static_cast<uint32_t>(data.size()));
+        slave_write_driver_.EnqueueWrite(next_id, addr,
+                                         data.subspan(0, transaction_bytes));
+        next_id = (next_id + 1) % max_outstanding_;
+        in_flight++;
+
+        data.remove_prefix(transaction_bytes);
+        addr += transaction_bytes;
       }
 
-      write_data.remove_prefix(transaction_bytes);
-      addr += transaction_bytes;
+      Step();
+      AxiCompletion completion;
+      while (slave_write_driver_.PopCompletion(&completion)) {
+        in_flight--;
+      }
     }
   }
 
   std::vector<uint8_t> Read(uint32_t addr, uint32_t len) {
-    std::vector<uint8_t> result;
-    result.reserve(len);
-    while (result.size() < len) {
-      uint32_t offset4096 = addr % 4096;
-      uint32_t remainder4096 = 4096 - offset4096;
-      uint32_t max_transaction_bytes = std::min(4096u, remainder4096);
-      uint32_t bytes_remaining = len - result.size();
-      uint32_t transaction_bytes = std::min(
-          static_cast<uint32_t>(bytes_remaining), max_transaction_bytes);
-
-      auto transaction =
-          slave_read_driver_.ReadTransaction(0, addr, transaction_bytes);
-      while (!(transaction->finished)) {
-        Step();
+    std::vector<uint8_t> result(len);
+    Read(addr, absl::MakeSpan(result));
+    return result;
+  }
+
+  // Reads over the slave port into `dest`. The bursts write straight into
+  // `dest`, with no intermediate buffer.
+  void Read(uint32_t addr, absl::Span<uint8_t> dest) {
+    int in_flight = 0;
+    int next_id = 0;
+    while (dest.size() > 0 || in_flight > 0) {
+      while (dest.size() > 0 && in_flight < max_outstanding_) {
+        uint32_t transaction_bytes =
+            ChunkBytes(addr, static_cast<uint32_t>(dest.size()));
+        slave_read_driver_.EnqueueRead(next_id, addr,
+                                       dest.subspan(0, transaction_bytes));
+        next_id = (next_id + 1) % max_outstanding_;
+        in_flight++;
+
+        dest.remove_prefix(transaction_bytes);
+        addr += transaction_bytes;
       }
-      std::copy(transaction->data.begin(), transaction->data.end(),
-                std::back_inserter(result));
 
-      addr += transaction_bytes;
+      Step();
+      AxiCompletion completion;
+      while (slave_read_driver_.PopCompletion(&completion)) {
+        in_flight--;
+      }
     }
-    return result;
   }
 
+  // Writes directly into the ITCM/DTCM arrays without advancing the clock.
+  // Returns false (and writes nothing) if the range is not wholly inside one
+  // TCM.
+  bool BackdoorWrite(uint32_t addr, uint32_t len, const char* data) {
+    return BackdoorWrite(
+        addr,
+        absl::Span<const uint8_t>(reinterpret_cast<const uint8_t*>(data), len));
+  }
+
+  bool BackdoorWrite(uint32_t addr, absl::Span<const uint8_t> data) {
+    TcmBackdoor* tcm = FindTcm(addr, data.size());
+    if (tcm == nullptr) {
+      return false;
+    }
+    tcm->Write(addr, data);
+    clock_.Eval();
+    return true;
+  }
+
+  // Reads directly from the ITCM/DTCM arrays without advancing the clock.
+  // Returns false if the range is not wholly inside one TCM.
+  bool BackdoorRead(uint32_t addr, uint32_t len, char* data) {
+    return BackdoorRead(
+        addr, absl::Span<uint8_t>(reinterpret_cast<uint8_t*>(data), len));
+  }
+
+  bool BackdoorRead(uint32_t addr, absl::Span<uint8_t> dest) {
+    TcmBackdoor* tcm = FindTcm(addr, dest.size());
+    if (tcm == nullptr) {
+      return false;
+    }
+    tcm->Read(addr, dest);
+    return true;
+  }
+
+  // Whether [addr, addr + len) lies wholly inside ITCM or DTCM.
+  bool InTcm(uint32_t addr, uint32_t len) {
+    return FindTcm(addr, len) != nullptr;
+  }
+
+  // Saves the model, the master-port queues, the mailbox and the cycle
+  // counters to `path`. The slave port must be idle, which it always is
+  // between Write()/Read()/WriteWord() calls. Returns false on failure, and
+  // always for models verilated with --threads, which are not --savable.
+  bool SaveCheckpoint(const std::string& path) {
+#if VERILATOR_THREADS > 1
+    (void)path;
+    return false;
+#else
+    if (slave_write_driver_.outstanding() != 0 ||
+        slave_read_driver_.outstanding() != 0) {
+      return false;
+    }
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+      return false;
+    }
+    uint64_t time = context_->time();
+    os.write(&time, sizeof(time));
+    os << core_;
+    master_read_driver_.Save(os);
+    master_write_driver_.Save(os);
+    os.write(&mailbox_, sizeof(mailbox_));
+    external_memory_.Save(os);
+    os.write(&cycles_, sizeof(cycles_));
+    os.write(&skipped_cycles_, sizeof(skipped_cycles_));
+    os.write(&quiescent_cycles_, sizeof(quiescent_cycles_));
+    os.write(&perf_, sizeof(perf_));
+    os.write(&slave_read_driver_.counters(), sizeof(AxiBeatCounters));
+    os.write(&slave_write_driver_.counters(), sizeof(AxiBeatCounters));
+    os.write(&master_read_driver_.counters(), sizeof(AxiBeatCounters));
+    os.write(&master_write_driver_.counters(), sizeof(AxiBeatCounters));
+    os.close();
+    return true;
+#endif
+  }
+
+  // Restores state written by SaveCheckpoint() from a wrapper around the
+  // same model. Replaces Reset() and program loading. Returns false if the
+  // file cannot be opened or the model was verilated with --threads.
+  bool RestoreCheckpoint(const std::string& path) {
+#if VERILATOR_THREADS > 1
+    (void)path;
+    return false;
+#else
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+      return false;
+    }
+    uint64_t time;
+    is.read(&time, sizeof(time));
+    context_->time(time);
+    is >> core_;
+    master_read_driver_.Restore(is);
+    master_write_driver_.Restore(is);
+    is.read(&mailbox_, sizeof(mailbox_));
+    external_memory_.Restore(is);
+    is.read(&cycles_, sizeof(cycles_));
+    is.read(&skipped_cycles_, sizeof(skipped_cycles_));
+    is.read(&quiescent_cycles_, sizeof(quiescent_cycles_));
+    is.read(&perf_, sizeof(perf_));
+    is.read(&slave_read_driver_.counters(), sizeof(AxiBeatCounters));
+    is.read(&slave_write_driver_.counters(), sizeof(AxiBeatCounters));
+    is.read(&master_read_driver_.counters(), sizeof(AxiBeatCounters));
+    is.read(&master_write_driver_.counters(), sizeof(AxiBeatCounters));
+    is.close();
+    return true;
+#endif
+  }
+
+  // Master-port accesses go to the mailbox or the external memory by default.
+  // These replace that decoding.
   void RegisterReadCallback(std::function<AxiRData(const AxiAddr&)> read_cb) {
     master_read_driver_.RegisterReadCallback(read_cb);
   }
@@ -198,13 +487,25 @@ class CoreMiniAxiWrapper {
   void WriteWord(uint32_t addr, uint32_t word) {
     absl::Span<const uint8_t> data_span(reinterpret_cast<uint8_t*>(&word),
                                         sizeof(word));
-    std::shared_ptr<bool> transaction =
-        slave_write_driver_.WriteTransaction(0, addr, data_span);
-    while (!(*transaction)) {
+    uint64_t tag = slave_write_driver_.EnqueueWrite(0, addr, data_span);
+    while (true) {
       Step();
+      AxiCompletion completion;
+      while (slave_write_driver_.PopCompletion(&completion)) {
+        if (completion.tag == tag) {
+          return;
+        }
+      }
     }
   }
 
+  // Releases the core from reset at `start_addr` through the CSR block.
+  void Start(uint32_t start_addr) {
+    WriteWord(kCsrAddr + 4, start_addr);
+    WriteWord(kCsrAddr, 1u);
+    WriteWord(kCsrAddr, 0u);
+  }
+
   bool WaitForTermination(int timeout = 10000) {
     for (int i = 0; i < timeout; i++) {
       if ((*halted_) || (*wfi_)) {
@@ -215,21 +516,160 @@ class CoreMiniAxiWrapper {
     return false;
   }
 
+  // Steps until doorbell_count() differs from `start_count`, for at most
+  // `timeout` cycles. Returns false on timeout or if the core halts first.
+  bool WaitForDoorbell(uint64_t timeout, uint64_t start_count) {
+    if (doorbell_count_ != start_count) {
+      return true;
+    }
+    for (uint64_t i = 0; i < timeout; i++) {
+      Step();
+      if (doorbell_count_ != start_count) {
+        return true;
+      }
+      if (*halted_) {
+        return false;
+      }
+    }
+    return false;
+  }
+
  private:
+  // Default number of slave-port bursts in flight for Write()/Read().
+  static constexpr int kDefaultMaxOutstanding = 4;
+  // Consecutive quiescent cycles required before StepCycles() skips, so that
+  // writes still draining out of the core reach the master port first.
+  static constexpr uint64_t kIdleSettleCycles = 16;
+
+  // Size of the next burst: at most 4 KiB and never crossing a 4 KiB boundary.
+  static uint32_t ChunkBytes(uint32_t addr, uint32_t bytes_remaining) {
+    uint32_t offset4096 = addr % 4096;
+    uint32_t remainder4096 = 4096 - offset4096;
+    uint32_t max_transaction_bytes = std::min(4096u, remainder4096);
+    return std::min(bytes_remaining, max_transaction_bytes);
+  }
+
+  // A model verilated with --threads N refuses a context with fewer threads,
+  // so size the context's pool before the model is constructed.
+  static VerilatedContext* WithModelThreads(VerilatedContext* context) {
+    if (context->threads() < VERILATOR_THREADS) {
+      context->threads(VERILATOR_THREADS);
+    }
+    return context;
+  }
+
+  static bool InMailbox(uint32_t addr) {
+    return addr >= kCoralNPUMailboxAddr &&
+           addr - kCoralNPUMailboxAddr < sizeof(CoralNPUMailbox);
+  }
+
+  AxiRData DeviceRead(const AxiAddr& addr) {
+    if (InMailbox(addr.addr_bits_addr)) {
+      AxiRData data = {};
+      memcpy(&data.read_data_bits_data[0], mailbox_.message,
+             sizeof(mailbox_.message));
+      data.read_data_bits_id = addr.addr_bits_id;
+      data.read_data_bits_last = 1;
+      return data;
+    }
+    if (external_memory_.Contains(addr.addr_bits_addr, 1)) {
+      return external_memory_.ReadBeat(addr);
+    }
+    AxiRData data = {};
+    data.read_data_bits_id = addr.addr_bits_id;
+    data.read_data_bits_resp = kAxiRespDecErr;
+    data.read_data_bits_last = 1;
+    return data;
+  }
+
+  AxiWResp DeviceWrite(const AxiAddr& addr, const AxiWData& data) {
+    if (InMailbox(addr.addr_bits_addr)) {
+      uint8_t* mailbox_data = reinterpret_cast<uint8_t*>(mailbox_.message);
+      const uint8_t* write_data =
+          reinterpret_cast<const uint8_t*>(&data.write_data_bits_data[0]);
+      for (int i = 0; i < 16; i++) {
+        if (data.write_data_bits_strb & (1 << i)) {
+          mailbox_data[i] = write_data[i];
+        }
+      }
+      // Handled after the cycle completes, outside the drivers.
+      constexpr uint16_t kDoorbellStrb = 0xf << (4 * kCoralNPUDoorbellWord);
+      if (data.write_data_bits_strb & kDoorbellStrb) {
+        doorbell_pending_ = true;
+      }
+      AxiWResp resp;
+      resp.write_resp_bits_id = addr.addr_bits_id;
+      resp.write_resp_bits_resp = kAxiRespOkay;
+      return resp;
+    }
+    if (external_memory_.Contains(addr.addr_bits_addr, 1)) {
+      return external_memory_.WriteBeat(addr, data);
+    }
+    AxiWResp resp;
+    resp.write_resp_bits_id = addr.addr_bits_id;
+    resp.write_resp_bits_resp = kAxiRespDecErr;
+    return resp;
+  }
+
+  // Attributes `cycles` cycles to the core's current state.
+  void CountCycles(uint64_t cycles) {
+    if (*halted_) {
+      perf_.halted_cycles += cycles;
+    } else if (*wfi_) {
+      perf_.wfi_cycles += cycles;
+    } else {
+      perf_.active_cycles += cycles;
+    }
+  }
+
+  static CoralNPUAxiTraffic Traffic(const AxiBeatCounters& counters) {
+    CoralNPUAxiTraffic traffic;
+    traffic.beats = counters.beats;
+    traffic.bytes = counters.bytes;
+    return traffic;
+  }
+
+  void RingDoorbell() {
+    doorbell_pending_ = false;
+    doorbell_count_++;
+    SetIrq(false);
+    if (doorbell_cb_) {
+      doorbell_cb_(mailbox_.message[kCoralNPUDoorbellWord]);
+    }
+  }
+
+  TcmBackdoor* FindTcm(uint32_t addr, uint32_t len) {
+    if (itcm_backdoor_.Contains(addr, len)) {
+      return &itcm_backdoor_;
+    }
+    if (dtcm_backdoor_.Contains(addr, len)) {
+      return &dtcm_backdoor_;
+    }
+    return nullptr;
+  }
+
   VerilatedContext* const context_;
   CoralNPUMailbox mailbox_;
-#ifdef ENABLE_RVV
-  VRvvCoreMiniAxi core_;
-#else
-  VCoreMiniAxi core_;
-#endif
+  CoreMiniAxiModel core_;
   Clock clock_;
   AxiSlaveWriteDriver slave_write_driver_;
   AxiSlaveReadDriver slave_read_driver_;
   AxiMasterReadDriver master_read_driver_;
   AxiMasterWriteDriver master_write_driver_;
+  TcmBackdoor itcm_backdoor_;
+  TcmBackdoor dtcm_backdoor_;
   const uint8_t* const halted_;
   const uint8_t* const wfi_;
+  ExternalMemory external_memory_;
+  int max_outstanding_ = kDefaultMaxOutstanding;
+  uint64_t cycles_ = 0;
+  uint64_t skipped_cycles_ = 0;
+  uint64_t quiescent_cycles_ = 0;
+  bool idle_skip_ = false;
+  CoralNPUPerfCounters perf_;
+  bool doorbell_pending_ = false;
+  uint64_t doorbell_count_ = 0;
+  std::function<void(uint32_t)> doorbell_cb_;
 };
 
 #endif  // HW_SIM_CORE_MINI_AXI_WRAPPER_H_
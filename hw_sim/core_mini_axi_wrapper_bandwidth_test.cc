@@ -0,0 +1,84 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures host-to-DTCM throughput over the AXI slave port, in bytes per
+// simulated cycle, with one outstanding burst and with pipelined bursts.
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "hw_sim/core_mini_axi_wrapper.h"
+
+namespace {
+
+struct Bandwidth {
+  double write_bytes_per_cycle;
+  double read_bytes_per_cycle;
+  bool data_ok;
+};
+
+Bandwidth Measure(int max_outstanding) {
+  VerilatedContext context;
+  CoreMiniAxiWrapper wrapper(&context);
+  wrapper.Reset();
+  wrapper.set_max_outstanding(max_outstanding);
+
+  std::vector<uint8_t> pattern(kDtcmSizeBytes);
+  for (uint32_t i = 0; i < kDtcmSizeBytes; i++) {
+    pattern[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+  }
+
+  uint64_t start = wrapper.cycles();
+  wrapper.Write(kDtcmAddr, kDtcmSizeBytes,
+                reinterpret_cast<const char*>(pattern.data()));
+  uint64_t write_cycles = wrapper.cycles() - start;
+
+  start = wrapper.cycles();
+  std::vector<uint8_t> readback = wrapper.Read(kDtcmAddr, kDtcmSizeBytes);
+  uint64_t read_cycles = wrapper.cycles() - start;
+
+  Bandwidth result;
+  result.write_bytes_per_cycle =
+      static_cast<double>(kDtcmSizeBytes) / static_cast<double>(write_cycles);
+  result.read_bytes_per_cycle =
+      static_cast<double>(kDtcmSizeBytes) / static_cast<double>(read_cycles);
+  result.data_ok = (readback == pattern);
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  Bandwidth serial = Measure(/*max_outstanding=*/1);
+  Bandwidth pipelined = Measure(/*max_outstanding=*/4);
+
+  std::cout << "serial:    write " << serial.write_bytes_per_cycle
+            << " B/cycle, read " << serial.read_bytes_per_cycle << " B/cycle"
+            << std::endl;
+  std::cout << "pipelined: write " << pipelined.write_bytes_per_cycle
+            << " B/cycle, read " << pipelined.read_bytes_per_cycle
+            << " B/cycle" << std::endl;
+
+  if (!serial.data_ok || !pipelined.data_ok) {
+    std::cout << "Readback mismatch" << std::endl;
+    return 1;
+  }
+  if (pipelined.write_bytes_per_cycle < serial.write_bytes_per_cycle ||
+      pipelined.read_bytes_per_cycle < serial.read_bytes_per_cycle) {
+    std::cout << "Pipelined transfers slower than serial" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checkpoints mailbox_example.elf part way through execution, then checks that
+// a second wrapper restored from the checkpoint finishes in exactly the same
+// state as the original.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hw_sim/core_mini_axi_wrapper.h"
+#include "hw_sim/elf_loader.h"
+
+namespace {
+
+// Cycles run after starting the core before the checkpoint is taken, and
+// after the checkpoint before states are compared.
+constexpr int kCyclesBeforeCheckpoint = 50;
+constexpr int kCyclesAfterCheckpoint = 2000;
+
+struct SimState {
+  uint64_t cycles;
+  uint64_t time;
+  CoralNPUMailbox mailbox;
+  std::vector<char> itcm;
+  std::vector<char> dtcm;
+
+  bool operator==(const SimState& other) const {
+    return cycles == other.cycles && time == other.time &&
+           memcmp(mailbox.message, other.mailbox.message,
+                  sizeof(mailbox.message)) == 0 &&
+           itcm == other.itcm && dtcm == other.dtcm;
+  }
+};
+
+SimState Finish(VerilatedContext* context, CoreMiniAxiWrapper* wrapper) {
+  wrapper->StepCycles(kCyclesAfterCheckpoint);
+  SimState state;
+  state.cycles = wrapper->cycles();
+  state.time = context->time();
+  state.mailbox = wrapper->mailbox();
+  state.itcm.resize(kItcmSizeBytes);
+  state.dtcm.resize(kDtcmSizeBytes);
+  wrapper->BackdoorRead(kItcmAddr, state.itcm.size(), state.itcm.data());
+  wrapper->BackdoorRead(kDtcmAddr, state.dtcm.size(), state.dtcm.data());
+  return state;
+}
+
+}  // namespace
+
+int main() {
+  MappedElf elf;
+  if (!elf.Open("hw_sim/mailbox_example.elf")) {
+    return 1;
+  }
+
+  const char* tmpdir = getenv("TEST_TMPDIR");
+  const std::string checkpoint =
+      std::string(tmpdir != nullptr ? tmpdir : "/tmp") +
+      "/core_mini_axi_wrapper_checkpoint";
+
+  SimState original;
+  double setup_seconds;
+  {
+    VerilatedContext context;
+    CoreMiniAxiWrapper wrapper(&context);
+    const auto start = std::chrono::steady_clock::now();
+    wrapper.Reset();
+    LoadElfAndStart(&wrapper, elf);
+    wrapper.StepCycles(kCyclesBeforeCheckpoint);
+    setup_seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    if (!wrapper.SaveCheckpoint(checkpoint)) {
+      std::cout << "SaveCheckpoint failed" << std::endl;
+      return 1;
+    }
+    original = Finish(&context, &wrapper);
+  }
+
+  SimState restored;
+  double restore_seconds;
+  {
+    VerilatedContext context;
+    CoreMiniAxiWrapper wrapper(&context);
+    const auto start = std::chrono::steady_clock::now();
+    if (!wrapper.RestoreCheckpoint(checkpoint)) {
+      std::cout << "RestoreCheckpoint failed" << std::endl;
+      return 1;
+    }
+    restore_seconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    restored = Finish(&context, &wrapper);
+  }
+
+  std::cout << "setup: " << setup_seconds << " s, restore: " << restore_seconds
+            << " s" << std::endl;
+  if (!(original == restored)) {
+    std::cout << "Restored run diverged from the original" << std::endl;
+    return 1;
+  }
+  if (original.mailbox.message[0] != 0xDEADBEEF) {
+    std::cout << "Program did not complete" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs mailbox_example.elf into WFI and then idles for a long stretch with and
+// without idle skip, checking that both runs agree on elapsed time.
+
+#include <cstdint>
+#include <iostream>
+
+#include "hw_sim/core_mini_axi_wrapper.h"
+#include "hw_sim/elf_loader.h"
+
+namespace {
+
+constexpr uint64_t kIdleCycles = 1000000;
+
+struct IdleResult {
+  bool terminated;
+  uint64_t cycles;
+  uint64_t skipped_cycles;
+  uint64_t time;
+  bool quiescent;
+};
+
+IdleResult RunAndIdle(const MappedElf& elf, bool idle_skip) {
+  VerilatedContext context;
+  CoreMiniAxiWrapper wrapper(&context);
+  wrapper.set_idle_skip(idle_skip);
+  wrapper.RegisterReadCallback([](const AxiAddr& addr) {
+    AxiRData data = {};
+    data.read_data_bits_id = addr.addr_bits_id;
+    data.read_data_bits_last = 1;
+    return data;
+  });
+  wrapper.RegisterWriteCallback([](const AxiAddr& addr, const AxiWData&) {
+    AxiWResp resp = {};
+    resp.write_resp_bits_id = addr.addr_bits_id;
+    return resp;
+  });
+  wrapper.Reset();
+
+  LoadElfAndStart(&wrapper, elf);
+
+  IdleResult result;
+  result.terminated = wrapper.WaitForTermination();
+  wrapper.StepCycles(kIdleCycles);
+  result.cycles = wrapper.cycles();
+  result.skipped_cycles = wrapper.skipped_cycles();
+  result.time = context.time();
+  result.quiescent = wrapper.Quiescent();
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  MappedElf elf;
+  if (!elf.Open("hw_sim/mailbox_example.elf")) {
+    return -1;
+  }
+
+  IdleResult stepped = RunAndIdle(elf, /*idle_skip=*/false);
+  IdleResult skipped = RunAndIdle(elf, /*idle_skip=*/true);
+
+  std::cout << "stepped: " << stepped.cycles << " cycles, "
+            << stepped.skipped_cycles << " skipped" << std::endl;
+  std::cout << "skipped: " << skipped.cycles << " cycles, "
+            << skipped.skipped_cycles << " skipped" << std::endl;
+
+  if (!stepped.terminated || !skipped.terminated) {
+    std::cout << "Program did not reach WFI" << std::endl;
+    return 1;
+  }
+  if (!stepped.quiescent || !skipped.quiescent) {
+    std::cout << "Design not quiescent after idling" << std::endl;
+    return 1;
+  }
+  if (stepped.skipped_cycles != 0) {
+    std::cout << "Cycles skipped with idle skip disabled" << std::endl;
+    return 1;
+  }
+  if (skipped.skipped_cycles == 0 ||
+      skipped.skipped_cycles > kIdleCycles) {
+    std::cout << "Unexpected skipped cycle count" << std::endl;
+    return 1;
+  }
+  if (stepped.cycles != skipped.cycles || stepped.time != skipped.time) {
+    std::cout << "Cycle accounting mismatch" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the core_mini_axi_simulator_example program under each Clock::EvalMode
+// and reports simulated cycles per host second.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/core_mini_axi_wrapper.h"
+#include "hw_sim/elf_loader.h"
+
+ABSL_FLAG(std::string, binary, "hw_sim/mailbox_example.elf",
+          "Binary to execute");
+ABSL_FLAG(int, cycles, 1000000, "Cycles to simulate per eval mode");
+
+namespace {
+
+double CyclesPerSecond(Clock::EvalMode eval_mode, const MappedElf& elf,
+                       uint64_t cycles) {
+  VerilatedContext context;
+  CoreMiniAxiWrapper wrapper(&context);
+  wrapper.set_eval_mode(eval_mode);
+  wrapper.RegisterReadCallback([](const AxiAddr& addr) {
+    AxiRData data = {};
+    data.read_data_bits_id = addr.addr_bits_id;
+    data.read_data_bits_last = 1;
+    return data;
+  });
+  wrapper.RegisterWriteCallback([](const AxiAddr& addr, const AxiWData&) {
+    AxiWResp resp = {};
+    resp.write_resp_bits_id = addr.addr_bits_id;
+    return resp;
+  });
+  wrapper.Reset();
+
+  const auto start = std::chrono::steady_clock::now();
+  LoadElfAndStart(&wrapper, elf);
+  while (wrapper.cycles() < cycles) {
+    wrapper.Step();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return wrapper.cycles() / std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  MappedElf elf;
+  if (!elf.Open(absl::GetFlag(FLAGS_binary))) {
+    return -1;
+  }
+  const uint64_t cycles = absl::GetFlag(FLAGS_cycles);
+
+  double per_observer =
+      CyclesPerSecond(Clock::EvalMode::kPerObserver, elf, cycles);
+  double two_phase = CyclesPerSecond(Clock::EvalMode::kTwoPhase, elf, cycles);
+
+  std::cout << "per-observer: " << per_observer << " cycles/s" << std::endl;
+  std::cout << "two-phase:    " << two_phase << " cycles/s" << std::endl;
+  std::cout << "speedup:      " << two_phase / per_observer << "x" << std::endl;
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures back-to-back small jobs served by resident firmware
+// (doorbell_example.elf) through the mailbox doorbell. The same jobs are then
+// run by reloading and restarting the program for each one, for comparison.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+ABSL_FLAG(std::string, binary, "hw_sim/doorbell_example.elf",
+          "Resident firmware to execute");
+ABSL_FLAG(int, jobs, 1000, "Number of jobs to run in each mode");
+ABSL_FLAG(int, job_words, 64, "Input words per job");
+
+namespace {
+
+// DTCM heap, unused by the firmware.
+constexpr uint32_t kInputAddr = 0x14000;
+constexpr uint64_t kJobTimeoutCycles = 100000;
+
+// Posts job `job` and raises the interrupt. Returns the expected sum.
+uint32_t PostJob(CoralNPUSimulator* simulator, int job,
+                 std::vector<uint32_t>* input) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < input->size(); i++) {
+    (*input)[i] = job * 31 + i;
+    sum += (*input)[i];
+  }
+  simulator->WriteTCM(kInputAddr, input->size() * sizeof(uint32_t),
+                      reinterpret_cast<const char*>(input->data()));
+  CoralNPUMailbox mailbox;
+  mailbox.message[0] = kInputAddr;
+  mailbox.message[1] = input->size();
+  simulator->WriteMailbox(mailbox);
+  simulator->SetIrq(true);
+  return sum;
+}
+
+// Runs the jobs and prints throughput. Returns false on a wrong answer.
+bool RunJobs(const char* mode, const MappedElf& elf, bool resident) {
+  std::unique_ptr<CoralNPUSimulator> simulator(CoralNPUSimulator::Create());
+  simulator->SetTCMAccessMode(TCMAccessMode::kBackdoor);
+  std::vector<uint32_t> input(absl::GetFlag(FLAGS_job_words));
+  const int jobs = absl::GetFlag(FLAGS_jobs);
+
+  const auto start = std::chrono::steady_clock::now();
+  const CoralNPUPerfCounters start_perf = simulator->ReadPerfCounters();
+  if (resident) {
+    uint32_t start_pc = LoadElfIntoSimulator(simulator.get(), elf);
+    simulator->Run(start_pc);
+    simulator->WaitForTermination(kJobTimeoutCycles);
+  }
+  for (int job = 0; job < jobs; job++) {
+    if (!resident) {
+      uint32_t start_pc = LoadElfIntoSimulator(simulator.get(), elf);
+      simulator->Run(start_pc);
+    }
+    uint32_t expected = PostJob(simulator.get(), job, &input);
+    if (!simulator->WaitForDoorbell(kJobTimeoutCycles)) {
+      std::cout << mode << ": job " << job << " timed out" << std::endl;
+      return false;
+    }
+    if (simulator->ReadMailbox().message[2] != expected) {
+      std::cout << mode << ": job " << job << " returned the wrong sum"
+                << std::endl;
+      return false;
+    }
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  const CoralNPUPerfCounters end_perf = simulator->ReadPerfCounters();
+  const uint64_t cycles = end_perf.cycles - start_perf.cycles;
+  const uint64_t instructions =
+      end_perf.instructions_dispatched() - start_perf.instructions_dispatched();
+
+  std::cout << mode << ": " << jobs / seconds << " jobs/s, "
+            << static_cast<double>(cycles) / jobs << " cycles/job, "
+            << static_cast<double>(instructions) / jobs
+            << " instructions/job" << std::endl;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  MappedElf elf;
+  if (!elf.Open(absl::GetFlag(FLAGS_binary))) {
+    return -1;
+  }
+  bool ok = RunJobs("resident", elf, true) && RunJobs("restart", elf, false);
+  return ok ? 0 : 1;
+}
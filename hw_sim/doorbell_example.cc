@@ -0,0 +1,46 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Resident firmware for the hw_sim doorbell protocol. Each host interrupt
+// carries a job in the mailbox: word 0 is the DTCM address of an array of
+// words and word 1 its length. The firmware clears word 0, returns the sum in
+// word 2 and writes the number of jobs served to word 3, the doorbell.
+
+#include <cstddef>
+#include <cstdint>
+
+// kCoralNPUMailboxAddr in hw_sim/mailbox.h.
+volatile uint32_t* mailbox = reinterpret_cast<volatile uint32_t*>(0x40000000L);
+
+int main() {
+  uint32_t jobs = 0;
+  while (true) {
+    asm volatile("wfi");
+    uint32_t addr = mailbox[0];
+    if (addr == 0) {
+      // Woken before the previous doorbell deasserted the interrupt.
+      continue;
+    }
+    const uint32_t* data = reinterpret_cast<const uint32_t*>(addr);
+    uint32_t count = mailbox[1];
+    mailbox[0] = 0;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      sum += data[i];
+    }
+    mailbox[2] = sum;
+    mailbox[3] = ++jobs;
+  }
+  return 0;
+}
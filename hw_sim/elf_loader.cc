@@ -0,0 +1,74 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hw_sim/elf_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+
+MappedElf::~MappedElf() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+bool MappedElf::Open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cout << "Failed to open " << path << std::endl;
+    return false;
+  }
+  struct stat sb;
+  if (fstat(fd, &sb) != 0) {
+    std::cout << "Failed to stat " << path << std::endl;
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    std::cout << "Failed to map " << path << std::endl;
+    return false;
+  }
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = static_cast<uint8_t*>(data);
+  size_ = sb.st_size;
+  return true;
+}
+
+uint32_t LoadElfIntoSimulator(CoralNPUSimulator* simulator,
+                              const uint8_t* elf) {
+  CopyFn copy_fn = [simulator](void* dest, const void* src, size_t count) {
+    uint32_t addr = static_cast<uint32_t>(reinterpret_cast<uint64_t>(dest));
+    simulator->WriteTCM(addr, count, reinterpret_cast<const char*>(src));
+    return dest;
+  };
+  // LoadElf only reads the image.
+  return LoadElf(const_cast<uint8_t*>(elf), copy_fn);
+}
+
+std::optional<uint32_t> LoadElfIntoSimulator(CoralNPUSimulator* simulator,
+                                             const std::string& path) {
+  MappedElf elf;
+  if (!elf.Open(path)) {
+    return std::nullopt;
+  }
+  return LoadElfIntoSimulator(simulator, elf);
+}
@@ -0,0 +1,76 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HW_SIM_ELF_LOADER_H_
+#define HW_SIM_ELF_LOADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "tests/verilator_sim/elf.h"
+
+// An ELF file mapped read-only, for programs that load it more than once.
+class MappedElf {
+ public:
+  MappedElf() = default;
+  ~MappedElf();
+  MappedElf(const MappedElf&) = delete;
+  MappedElf& operator=(const MappedElf&) = delete;
+
+  // Maps `path`. Prints the reason and returns false on failure.
+  bool Open(const std::string& path);
+
+  uint8_t* data() const { return data_; }
+
+ private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Writes the segments of the ELF image at `elf` with simulator->WriteTCM()
+// and returns the entry point. The core is not started; pass the result to
+// Run().
+uint32_t LoadElfIntoSimulator(CoralNPUSimulator* simulator,
+                              const uint8_t* elf);
+
+inline uint32_t LoadElfIntoSimulator(CoralNPUSimulator* simulator,
+                                     const MappedElf& elf) {
+  return LoadElfIntoSimulator(simulator, elf.data());
+}
+
+// As above, mapping `path` for the duration of the load. Returns nullopt if
+// the file cannot be opened.
+std::optional<uint32_t> LoadElfIntoSimulator(CoralNPUSimulator* simulator,
+                                             const std::string& path);
+
+// Writes the segments of `elf` over the slave port of a CoreMiniAxiWrapper
+// and releases the core from reset at the entry point, which is returned.
+// A template so that this library does not pick one of the wrapper's model
+// variants.
+template <typename Wrapper>
+uint32_t LoadElfAndStart(Wrapper* wrapper, const MappedElf& elf) {
+  CopyFn copy_fn = [wrapper](void* dest, const void* src, size_t count) {
+    uint32_t addr = static_cast<uint32_t>(reinterpret_cast<uint64_t>(dest));
+    wrapper->Write(addr, count, reinterpret_cast<const char*>(src));
+    return dest;
+  };
+  uint32_t start_pc = LoadElf(elf.data(), copy_fn);
+  wrapper->Start(start_pc);
+  return start_pc;
+}
+
+#endif  // HW_SIM_ELF_LOADER_H_
@@ -0,0 +1,154 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hw_sim/external_memory.h"
+
+#include <algorithm>
+#include <cstring>
+
+bool ExternalMemory::Map(uint32_t addr, uint32_t len) {
+  if (!Contains(addr, len)) {
+    return false;
+  }
+  if (len == 0) {
+    return true;
+  }
+  uint32_t first = (addr - base_addr_) / kPageBytes;
+  uint32_t last = (addr - base_addr_ + len - 1) / kPageBytes;
+  for (uint32_t page = first; page <= last; page++) {
+    GetPage(page);
+  }
+  return true;
+}
+
+bool ExternalMemory::Fill(uint32_t addr, uint32_t len, uint8_t value) {
+  if (!Contains(addr, len)) {
+    return false;
+  }
+  uint32_t offset = addr - base_addr_;
+  while (len > 0) {
+    uint32_t page_offset = offset % kPageBytes;
+    uint32_t bytes = std::min(len, kPageBytes - page_offset);
+    memset(GetPage(offset / kPageBytes)->data() + page_offset, value, bytes);
+    offset += bytes;
+    len -= bytes;
+  }
+  return true;
+}
+
+bool ExternalMemory::Write(uint32_t addr, absl::Span<const uint8_t> data) {
+  if (!Contains(addr, data.size())) {
+    return false;
+  }
+  uint32_t offset = addr - base_addr_;
+  while (data.size() > 0) {
+    uint32_t page_offset = offset % kPageBytes;
+    uint32_t bytes = std::min(static_cast<uint32_t>(data.size()),
+                              kPageBytes - page_offset);
+    memcpy(GetPage(offset / kPageBytes)->data() + page_offset, data.data(),
+           bytes);
+    data.remove_prefix(bytes);
+    offset += bytes;
+  }
+  return true;
+}
+
+bool ExternalMemory::Read(uint32_t addr, absl::Span<uint8_t> data) const {
+  if (!Contains(addr, data.size())) {
+    return false;
+  }
+  uint32_t offset = addr - base_addr_;
+  while (data.size() > 0) {
+    uint32_t page_offset = offset % kPageBytes;
+    uint32_t bytes = std::min(static_cast<uint32_t>(data.size()),
+                              kPageBytes - page_offset);
+    const Page* page = FindPage(offset / kPageBytes);
+    if (page != nullptr) {
+      memcpy(data.data(), page->data() + page_offset, bytes);
+    } else {
+      memset(data.data(), 0, bytes);
+    }
+    data.remove_prefix(bytes);
+    offset += bytes;
+  }
+  return true;
+}
+
+AxiRData ExternalMemory::ReadBeat(const AxiAddr& addr) const {
+  AxiRData data = {};
+  data.read_data_bits_id = addr.addr_bits_id;
+  data.read_data_bits_last = 1;
+  uint32_t line = addr.addr_bits_addr & ~(kBeatBytes - 1);
+  auto beat = absl::Span<uint8_t>(
+      reinterpret_cast<uint8_t*>(&data.read_data_bits_data[0]), kBeatBytes);
+  data.read_data_bits_resp = Read(line, beat) ? kAxiRespOkay : kAxiRespSlvErr;
+  return data;
+}
+
+AxiWResp ExternalMemory::WriteBeat(const AxiAddr& addr, const AxiWData& data) {
+  AxiWResp resp;
+  resp.write_resp_bits_id = addr.addr_bits_id;
+  uint32_t line = addr.addr_bits_addr & ~(kBeatBytes - 1);
+  if (!Contains(line, kBeatBytes)) {
+    resp.write_resp_bits_resp = kAxiRespSlvErr;
+    return resp;
+  }
+  // A line never straddles a page.
+  uint32_t offset = line - base_addr_;
+  uint8_t* dest = GetPage(offset / kPageBytes)->data() + offset % kPageBytes;
+  const uint8_t* src =
+      reinterpret_cast<const uint8_t*>(&data.write_data_bits_data[0]);
+  for (uint32_t i = 0; i < kBeatBytes; i++) {
+    if (data.write_data_bits_strb & (1 << i)) {
+      dest[i] = src[i];
+    }
+  }
+  resp.write_resp_bits_resp = kAxiRespOkay;
+  return resp;
+}
+
+void ExternalMemory::Save(VerilatedSerialize& os) const {
+  uint64_t num_pages = pages_.size();
+  os.write(&num_pages, sizeof(num_pages));
+  for (const auto& [index, page] : pages_) {
+    os.write(&index, sizeof(index));
+    os.write(page->data(), kPageBytes);
+  }
+}
+
+void ExternalMemory::Restore(VerilatedDeserialize& is) {
+  pages_.clear();
+  uint64_t num_pages;
+  is.read(&num_pages, sizeof(num_pages));
+  for (uint64_t i = 0; i < num_pages; i++) {
+    uint32_t index;
+    is.read(&index, sizeof(index));
+    is.read(GetPage(index)->data(), kPageBytes);
+  }
+}
+
+ExternalMemory::Page* ExternalMemory::GetPage(uint32_t page_index) {
+  auto& page = pages_[page_index];
+  if (!page) {
+    page = std::make_unique<Page>();
+    page->fill(0);
+  }
+  return page.get();
+}
+
+const ExternalMemory::Page* ExternalMemory::FindPage(
+    uint32_t page_index) const {
+  auto it = pages_.find(page_index);
+  return it == pages_.end() ? nullptr : it->second.get();
+}
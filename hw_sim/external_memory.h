@@ -0,0 +1,81 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HW_SIM_EXTERNAL_MEMORY_H_
+#define HW_SIM_EXTERNAL_MEMORY_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "absl/types/span.h"
+#include "hw_sim/hw_primitives.h"
+
+// Default location of the external memory behind the core's AXI master port,
+// matching EXTMEM in toolchain/coralnpu_tcm_highmem.ld.
+constexpr uint32_t kExternalMemoryAddr = 0x20000000;
+constexpr uint32_t kExternalMemorySizeBytes = 0x400000;
+
+// A sparse memory backed by 4 KiB pages that are allocated on first write or
+// when mapped. Unallocated pages read as zero.
+class ExternalMemory {
+ public:
+  static constexpr uint32_t kPageBytes = 4096;
+
+  ExternalMemory(uint32_t base_addr, uint32_t size_bytes)
+      : base_addr_(base_addr), size_bytes_(size_bytes) {}
+
+  uint32_t base_addr() const { return base_addr_; }
+  uint32_t size_bytes() const { return size_bytes_; }
+
+  bool Contains(uint32_t addr, uint32_t len) const {
+    return addr >= base_addr_ && len <= size_bytes_ &&
+           (addr - base_addr_) <= (size_bytes_ - len);
+  }
+
+  // Allocates zeroed pages covering [addr, addr + len). Returns false if the
+  // range is outside the memory.
+  bool Map(uint32_t addr, uint32_t len);
+  // Sets every byte of [addr, addr + len) to `value`.
+  bool Fill(uint32_t addr, uint32_t len, uint8_t value);
+  bool Write(uint32_t addr, absl::Span<const uint8_t> data);
+  bool Read(uint32_t addr, absl::Span<uint8_t> data) const;
+
+  // Serves one 16-byte beat of a master-port access. The beat covers the
+  // aligned line containing the address; the core selects its byte lanes.
+  AxiRData ReadBeat(const AxiAddr& addr) const;
+  AxiWResp WriteBeat(const AxiAddr& addr, const AxiWData& data);
+
+  // Number of pages currently allocated.
+  size_t mapped_pages() const { return pages_.size(); }
+
+  // Checkpoint support: allocated pages only.
+  void Save(VerilatedSerialize& os) const;
+  void Restore(VerilatedDeserialize& is);
+
+ private:
+  static constexpr uint32_t kBeatBytes = 16;
+  using Page = std::array<uint8_t, kPageBytes>;
+
+  Page* GetPage(uint32_t page_index);
+  const Page* FindPage(uint32_t page_index) const;
+
+  const uint32_t base_addr_;
+  const uint32_t size_bytes_;
+  // Indexed by (addr - base_addr_) / kPageBytes.
+  std::unordered_map<uint32_t, std::unique_ptr<Page>> pages_;
+};
+
+#endif  // HW_SIM_EXTERNAL_MEMORY_H_
@@ -0,0 +1,83 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks host and per-beat access to ExternalMemory, including writes that
+// straddle pages, byte strobes and out-of-range responses.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "hw_sim/external_memory.h"
+#include "tests/verilator_sim/test_check.h"
+
+int main() {
+  ExternalMemory memory(kExternalMemoryAddr, kExternalMemorySizeBytes);
+  bool ok = true;
+
+  // Unmapped memory reads as zero and allocates nothing.
+  std::vector<uint8_t> buffer(64, 0xff);
+  ok &= Check(memory.Read(kExternalMemoryAddr + 0x1000, absl::MakeSpan(buffer)),
+              "read unmapped");
+  ok &= Check(buffer == std::vector<uint8_t>(64, 0), "unmapped reads zero");
+  ok &= Check(memory.mapped_pages() == 0, "read allocated a page");
+
+  // A write straddling a page boundary lands in two pages.
+  std::vector<uint8_t> data(64);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i + 1);
+  }
+  const uint32_t straddle =
+      kExternalMemoryAddr + ExternalMemory::kPageBytes - 32;
+  ok &= Check(memory.Write(straddle, absl::MakeConstSpan(data)), "write");
+  ok &= Check(memory.mapped_pages() == 2, "straddling write pages");
+  ok &= Check(memory.Read(straddle, absl::MakeSpan(buffer)), "read back");
+  ok &= Check(buffer == data, "straddling readback");
+
+  // Fill and Map.
+  ok &= Check(memory.Fill(kExternalMemoryAddr + 0x10000, 16, 0xa5), "fill");
+  ok &= Check(memory.Map(kExternalMemoryAddr + 0x20000, 0x2000), "map");
+  ok &= Check(memory.mapped_pages() == 5, "mapped page count");
+
+  // Beats cover the aligned line and honour the write strobe.
+  AxiAddr addr = {};
+  addr.addr_bits_addr = kExternalMemoryAddr + 0x10004;
+  addr.addr_bits_id = 3;
+  AxiWData wdata = {};
+  memset(&wdata.write_data_bits_data[0], 0x11, 16);
+  wdata.write_data_bits_strb = 0x00f0;
+  AxiWResp wresp = memory.WriteBeat(addr, wdata);
+  ok &= Check(wresp.write_resp_bits_resp == kAxiRespOkay, "beat write resp");
+  ok &= Check(wresp.write_resp_bits_id == 3, "beat write id");
+  AxiRData rdata = memory.ReadBeat(addr);
+  ok &= Check(rdata.read_data_bits_resp == kAxiRespOkay, "beat read resp");
+  ok &= Check(rdata.read_data_bits_id == 3, "beat read id");
+  ok &= Check(rdata.read_data_bits_data[0] == 0xa5a5a5a5 &&
+                  rdata.read_data_bits_data[1] == 0x11111111 &&
+                  rdata.read_data_bits_data[2] == 0xa5a5a5a5,
+              "beat data");
+
+  // Accesses outside the memory are rejected.
+  addr.addr_bits_addr = kExternalMemoryAddr + kExternalMemorySizeBytes;
+  ok &= Check(memory.ReadBeat(addr).read_data_bits_resp == kAxiRespSlvErr,
+              "out of range read");
+  ok &= Check(memory.WriteBeat(addr, wdata).write_resp_bits_resp ==
+                  kAxiRespSlvErr,
+              "out of range write");
+  ok &= Check(!memory.Write(kExternalMemoryAddr + kExternalMemorySizeBytes - 8,
+                            absl::MakeConstSpan(data)),
+              "overrunning host write");
+
+  return TestResult(ok);
+}
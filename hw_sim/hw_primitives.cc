@@ -24,6 +24,25 @@ Clock::Observer::~Observer() {
 }
 
 void Clock::Step() {
+  if (eval_mode_ == EvalMode::kTwoPhase) {
+    // Handshakes completing on this rising edge are visible now.
+    for (auto& observer : observers_) {
+      observer->Sample();
+    }
+    context_->timeInc(1);
+    (*clock_) = 1;
+    Eval();
+
+    context_->timeInc(1);
+    (*clock_) = 0;
+    Eval();
+    for (auto& observer : observers_) {
+      observer->Drive();
+    }
+    Eval();
+    return;
+  }
+
   context_->timeInc(1);
   (*clock_) = 1;
   Eval();
@@ -41,6 +60,10 @@ void Clock::Step() {
   }
 }
 
+void Clock::Skip(uint64_t cycles) {
+  context_->timeInc(2 * cycles);
+}
+
 void Clock::Eval() {
   eval_function_();
 }
@@ -71,7 +94,7 @@ AxiAddr AxiAddr::FromIdAddrSize(int id, uint32_t addr, uint32_t byte_length) {
   axi_addr.addr_bits_id = id;
   axi_addr.addr_bits_len = beats - 1;
   axi_addr.addr_bits_size = size;
-  axi_addr.addr_bits_burst = 1;  // INCR
+  axi_addr.addr_bits_burst = kAxiBurstIncr;
   axi_addr.addr_bits_lock = 0;
   axi_addr.addr_bits_cache = 0;
   axi_addr.addr_bits_qos = 0;
@@ -79,3 +102,18 @@ AxiAddr AxiAddr::FromIdAddrSize(int id, uint32_t addr, uint32_t byte_length) {
   return axi_addr;
 }
 
+
+uint32_t AxiAddr::BeatAddr(uint32_t beat) const {
+  if (beat == 0 || addr_bits_burst == kAxiBurstFixed) {
+    return addr_bits_addr;
+  }
+  const uint32_t bytes = 1u << addr_bits_size;
+  const uint32_t aligned = addr_bits_addr & ~(bytes - 1);
+  if (addr_bits_burst == kAxiBurstWrap) {
+    // WRAP bursts are 2, 4, 8 or 16 beats and start aligned to the size.
+    const uint32_t total = bytes * (addr_bits_len + 1);
+    const uint32_t wrap_base = aligned & ~(total - 1);
+    return wrap_base + (aligned - wrap_base + beat * bytes) % total;
+  }
+  return aligned + beat * bytes;
+}
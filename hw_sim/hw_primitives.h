@@ -16,15 +16,93 @@
 #define HW_SIM_HW_PRIMITIVES_H_
 
 #include <verilated.h>
+#include <verilated_save.h>
 
 #include <algorithm>
-#include <map>
-#include <memory>
-#include <queue>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <type_traits>
 #include <vector>
 
+#include "absl/log/check.h"
 #include "absl/types/span.h"
 
+// Number of distinct AXI IDs on the core's ports (axi2IdBits in
+// Parameters.scala).
+constexpr int kAxiNumIds = 64;
+
+// Number of bursts a slave driver can have queued or awaiting a response.
+constexpr size_t kAxiMaxOutstanding = 32;
+
+// Depth of the response queues in the master drivers.
+constexpr size_t kAxiMasterQueueDepth = 256;
+
+// AXI4 AxBURST encodings.
+constexpr uint8_t kAxiBurstFixed = 0;
+constexpr uint8_t kAxiBurstIncr = 1;
+constexpr uint8_t kAxiBurstWrap = 2;
+
+// AXI4 RRESP/BRESP encodings.
+constexpr uint8_t kAxiRespOkay = 0;
+constexpr uint8_t kAxiRespSlvErr = 2;
+constexpr uint8_t kAxiRespDecErr = 3;
+
+// A fixed-capacity FIFO. It never allocates after construction, which keeps
+// the per-cycle driver paths free of heap traffic.
+template <typename T, size_t N>
+class RingBuffer {
+ public:
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == N; }
+  size_t size() const { return size_; }
+
+  T& front() { return items_[head_]; }
+  const T& front() const { return items_[head_]; }
+
+  // Overflow and underflow abort in every build mode, rather than silently
+  // overwriting unread entries when asserts are compiled out.
+  void push(const T& item) {
+    CHECK(!full()) << "RingBuffer overflow";
+    items_[(head_ + size_) % N] = item;
+    size_++;
+  }
+
+  void pop() {
+    CHECK(!empty()) << "RingBuffer underflow";
+    head_ = (head_ + 1) % N;
+    size_--;
+  }
+
+  // Checkpoint support. Elements are written as raw bytes.
+  void Save(VerilatedSerialize& os) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingBuffer::Save needs a trivially copyable T");
+    uint64_t size = size_;
+    os.write(&size, sizeof(size));
+    for (size_t i = 0; i < size_; i++) {
+      os.write(&items_[(head_ + i) % N], sizeof(T));
+    }
+  }
+
+  void Restore(VerilatedDeserialize& is) {
+    uint64_t size;
+    is.read(&size, sizeof(size));
+    CHECK_LE(size, N) << "RingBuffer checkpoint is larger than its capacity";
+    head_ = 0;
+    size_ = size;
+    for (size_t i = 0; i < size_; i++) {
+      is.read(&items_[i], sizeof(T));
+    }
+  }
+
+ private:
+  std::array<T, N> items_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
 // A class that wraps and controls a verilator clock signal. Also provides an
 // observer mechanism
 class Clock {
@@ -36,9 +114,18 @@ class Clock {
     explicit Observer(Clock* clock);
     virtual ~Observer();
 
+    // Used in EvalMode::kPerObserver. Called after each edge; the model is
+    // evaluated after every call.
     virtual void OnRisingEdge() {}
     virtual void OnFallingEdge() {}
 
+    // Used in EvalMode::kTwoPhase. Sample() is called on every observer just
+    // before the rising edge and must only read model outputs; valid/ready
+    // pairs seen high there complete on that edge. Drive() is called on every
+    // observer after the falling edge and stages the next inputs.
+    virtual void Sample() {}
+    virtual void Drive() {}
+
    protected:
     Clock& clock() { return *clock_; }
 
@@ -46,6 +133,16 @@ class Clock {
     Clock* const clock_;
   };
 
+  // How observers are scheduled around the model's eval().
+  enum class EvalMode {
+    // Sample/Drive on all observers, then a single eval. Three evals per
+    // cycle regardless of the number of observers.
+    kTwoPhase,
+    // Compatibility mode: OnRisingEdge/OnFallingEdge with an eval after each
+    // observer, and any extra evals the observers issue themselves.
+    kPerObserver,
+  };
+
   template <typename Model>
   Clock(VerilatedContext* context, uint8_t* clock, Model* model)
       : context_(context),
@@ -53,9 +150,17 @@ class Clock {
         eval_function_([model]() { model->eval(); }) {}
   ~Clock() = default;
 
+  void set_eval_mode(EvalMode eval_mode) { eval_mode_ = eval_mode; }
+  EvalMode eval_mode() const { return eval_mode_; }
+
   // Advance the clock on cycle (one positive edge, one negative edge).
   void Step();
 
+  // Advances simulation time by `cycles` clock periods without toggling the
+  // clock, evaluating the model or notifying observers. Only valid when the
+  // design is known to be quiescent.
+  void Skip(uint64_t cycles);
+
   // Update the simulation. If observers change input signals to the design,
   // they should call this function to ensure internal signals get updated.
   void Eval();
@@ -68,6 +173,7 @@ class Clock {
   uint8_t* const clock_;
   std::function<void()> eval_function_;
   std::vector<Observer*> observers_;
+  EvalMode eval_mode_ = EvalMode::kTwoPhase;
 };
 
 // Struct representing the data transferred in an AXI4 read/write addr channel.
@@ -86,6 +192,10 @@ struct AxiAddr {
   // Create an AxiAddr from a transfer id, starting address and transaction
   // length.
   static AxiAddr FromIdAddrSize(int id, uint32_t addr, uint32_t byte_length);
+
+  // Address of beat `beat` of this burst, following AxBURST (FIXED, INCR or
+  // WRAP) and AxSIZE. Beats after the first are size-aligned.
+  uint32_t BeatAddr(uint32_t beat) const;
 };
 
 // Struct representing the data transferred in an AXI4 write data channel.
@@ -95,7 +205,23 @@ struct AxiWData {
   uint8_t write_data_bits_last;
 };
 
+// Data beats and bytes moved through one AXI driver.
+struct AxiBeatCounters {
+  uint64_t beats = 0;
+  uint64_t bytes = 0;
+};
+
+// Record of a finished transaction on an AXI4 slave port. Completions are
+// reported in the order the responses arrive.
+struct AxiCompletion {
+  uint64_t tag;
+  uint8_t id;
+  uint8_t resp;
+};
+
 // A driver to control interactions of the write channels in an AXI4 slave.
+// Up to kAxiMaxOutstanding bursts may be outstanding, across any IDs. Bursts
+// sharing an ID complete in issue order, as required by AXI.
 class AxiSlaveWriteDriver : Clock::Observer {
  public:
   AxiSlaveWriteDriver(
@@ -137,65 +263,133 @@ class AxiSlaveWriteDriver : Clock::Observer {
   }
   ~AxiSlaveWriteDriver() final = default;
 
-  std::shared_ptr<bool> WriteTransaction(int id, uint32_t addr,
-                                         absl::Span<const uint8_t> data) {
-    // Enqueue addr
-    AxiAddr axi_addr = AxiAddr::FromIdAddrSize(id, addr, data.size());
-    EnqueueAddr(axi_addr);
-
-    // Enqueue data
-    while (data.size() > 0) {
-      uint32_t base_addr = (addr / 16) * 16;
-      uint32_t sub_addr = addr - base_addr;
-      uint32_t bytes_to_write = 16 - sub_addr;
-      bytes_to_write =
-          std::min(static_cast<uint32_t>(data.size()), bytes_to_write);
-      absl::Span<const uint8_t> local_data = data.subspan(0, bytes_to_write);
-
-      AxiWData axi_data;
-      uint8_t* data_ptr =
-          reinterpret_cast<uint8_t*>(&(axi_data.write_data_bits_data[0])) +
-          sub_addr;
-      memcpy(data_ptr, local_data.data(), bytes_to_write);
-      axi_data.write_data_bits_strb = 0;
-      for (uint32_t i = sub_addr; i < sub_addr + bytes_to_write; i++) {
-        axi_data.write_data_bits_strb |= (1 << i);
-      }
-      axi_data.write_data_bits_last = (bytes_to_write == data.size());
-      EnqueueData(axi_data);
+  // Queues a write burst. `data` is read as beats are sent and must stay valid
+  // until the burst completes. Returns a tag identifying the burst in the
+  // completion queue.
+  uint64_t EnqueueWrite(int id, uint32_t addr, absl::Span<const uint8_t> data) {
+    assert(CanEnqueue());
+    assert(id >= 0 && id < kAxiNumIds);
+    addr_queue_.push(AxiAddr::FromIdAddrSize(id, addr, data.size()));
+    data_queue_.push({addr, data});
+    uint64_t tag = next_tag_++;
+    outstanding_transactions_[id].push(tag);
+    outstanding_count_++;
+    return tag;
+  }
 
-      data.remove_prefix(bytes_to_write);
-      addr += bytes_to_write;
+  // Whether another burst fits. Completions must be popped to free room.
+  bool CanEnqueue() const {
+    return outstanding_count_ + completions_.size() < kAxiMaxOutstanding;
+  }
+
+  // Pops the oldest completed burst. Returns false if there is none.
+  bool PopCompletion(AxiCompletion* completion) {
+    if (completions_.empty()) {
+      return false;
     }
+    *completion = completions_.front();
+    completions_.pop();
+    return true;
+  }
 
-    assert(outstanding_transactions_.find(id) ==
-           outstanding_transactions_.end());
+  // Number of bursts issued but not yet acknowledged.
+  size_t outstanding() const { return outstanding_count_; }
 
-    const auto [it, success] =
-        outstanding_transactions_.insert({id, std::make_shared<bool>(false)});
-    return it->second;
-  }
+  // Write beats sent and bytes enabled in them.
+  AxiBeatCounters& counters() { return counters_; }
+  const AxiBeatCounters& counters() const { return counters_; }
 
  private:
-  void EnqueueAddr(const AxiAddr& addr) { addr_queue_.push(addr); }
+  // Source data of a burst that still has beats to send.
+  struct WriteBurst {
+    uint32_t addr;
+    absl::Span<const uint8_t> data;
+  };
 
-  void EnqueueData(const AxiWData& data) { data_queue_.push(data); }
+  // Builds the next beat of the oldest burst into `beat_`.
+  void StageBeat() {
+    WriteBurst& burst = data_queue_.front();
+    uint32_t sub_addr = burst.addr % 16;
+    uint32_t bytes_to_write =
+        std::min(16 - sub_addr, static_cast<uint32_t>(burst.data.size()));
+    uint8_t* data_ptr =
+        reinterpret_cast<uint8_t*>(&(beat_.write_data_bits_data[0]));
+    memcpy(data_ptr + sub_addr, burst.data.data(), bytes_to_write);
+    beat_.write_data_bits_strb = ((1u << bytes_to_write) - 1) << sub_addr;
+    burst.data.remove_prefix(bytes_to_write);
+    burst.addr += bytes_to_write;
+    beat_.write_data_bits_last = burst.data.empty();
+    if (beat_.write_data_bits_last) {
+      data_queue_.pop();
+    }
+    beat_staged_ = true;
+  }
+
+  void BeatSent() {
+    beat_staged_ = false;
+    counters_.beats++;
+    counters_.bytes += __builtin_popcount(beat_.write_data_bits_strb);
+  }
+
+  void Sample() final {
+    if (*write_addr_valid_ && *write_addr_ready_) {
+      addr_queue_.pop();
+    }
+    if (*write_data_valid_ && *write_data_ready_) {
+      BeatSent();
+    }
+    if (*write_resp_valid_ && *write_resp_ready_) {
+      ReceiveResponse();
+    }
+  }
+
+  void Drive() final {
+    *write_addr_valid_ = !addr_queue_.empty();
+    if (!addr_queue_.empty()) {
+      SetAddr(addr_queue_.front());
+    }
+
+    if (!beat_staged_ && !data_queue_.empty()) {
+      StageBeat();
+    }
+    *write_data_valid_ = beat_staged_;
+    if (beat_staged_) {
+      *write_data_bits_data_ = beat_.write_data_bits_data;
+      *write_data_bits_strb_ = beat_.write_data_bits_strb;
+      *write_data_bits_last_ = beat_.write_data_bits_last;
+    }
+  }
+
+  void SetAddr(const AxiAddr& addr) {
+    *write_addr_bits_addr_ = addr.addr_bits_addr;
+    *write_addr_bits_prot_ = addr.addr_bits_prot;
+    *write_addr_bits_id_ = addr.addr_bits_id;
+    *write_addr_bits_len_ = addr.addr_bits_len;
+    *write_addr_bits_size_ = addr.addr_bits_size;
+    *write_addr_bits_burst_ = addr.addr_bits_burst;
+    *write_addr_bits_lock_ = addr.addr_bits_lock;
+    *write_addr_bits_cache_ = addr.addr_bits_cache;
+    *write_addr_bits_qos_ = addr.addr_bits_qos;
+    *write_addr_bits_region_ = addr.addr_bits_region;
+  }
+
+  void ReceiveResponse() {
+    assert(*write_resp_bits_resp_ == 0);
+    auto& pending = outstanding_transactions_[*write_resp_bits_id_];
+    if (!pending.empty()) {
+      completions_.push(
+          {pending.front(), *write_resp_bits_id_, *write_resp_bits_resp_});
+      pending.pop();
+      outstanding_count_--;
+    }
+  }
 
   void OnFallingEdge() final {
     // Send Addr
     *write_addr_valid_ = !addr_queue_.empty();
     clock().Eval();
     if (!addr_queue_.empty()) {
-      *write_addr_bits_addr_ = addr_queue_.front().addr_bits_addr;
-      *write_addr_bits_prot_ = addr_queue_.front().addr_bits_prot;
-      *write_addr_bits_id_ = addr_queue_.front().addr_bits_id;
-      *write_addr_bits_len_ = addr_queue_.front().addr_bits_len;
-      *write_addr_bits_size_ = addr_queue_.front().addr_bits_size;
-      *write_addr_bits_burst_ = addr_queue_.front().addr_bits_burst;
-      *write_addr_bits_lock_ = addr_queue_.front().addr_bits_lock;
-      *write_addr_bits_cache_ = addr_queue_.front().addr_bits_cache;
-      *write_addr_bits_qos_ = addr_queue_.front().addr_bits_qos;
-      *write_addr_bits_region_ = addr_queue_.front().addr_bits_region;
+      SetAddr(addr_queue_.front());
       if (*write_addr_ready_) {
         addr_queue_.pop();
       }
@@ -203,26 +397,24 @@ class AxiSlaveWriteDriver : Clock::Observer {
     }
 
     // Send Data
-    *write_data_valid_ = !data_queue_.empty();
+    if (!beat_staged_ && !data_queue_.empty()) {
+      StageBeat();
+    }
+    *write_data_valid_ = beat_staged_;
     clock().Eval();
-    if (!data_queue_.empty()) {
-      *write_data_bits_data_ = data_queue_.front().write_data_bits_data;
-      *write_data_bits_strb_ = data_queue_.front().write_data_bits_strb;
-      *write_data_bits_last_ = data_queue_.front().write_data_bits_last;
+    if (beat_staged_) {
+      *write_data_bits_data_ = beat_.write_data_bits_data;
+      *write_data_bits_strb_ = beat_.write_data_bits_strb;
+      *write_data_bits_last_ = beat_.write_data_bits_last;
       if (*write_data_ready_) {
-        data_queue_.pop();
+        BeatSent();
       }
       clock().Eval();
     }
 
     // Receive Response
     if (*write_resp_valid_) {
-      assert(*write_resp_bits_resp_ == 0);
-      auto it = outstanding_transactions_.find(*write_resp_bits_id_);
-      if (it != outstanding_transactions_.end()) {
-        *(it->second) = true;
-        outstanding_transactions_.erase(it);
-      }
+      ReceiveResponse();
     }
   }
 
@@ -252,20 +444,24 @@ class AxiSlaveWriteDriver : Clock::Observer {
   const uint8_t* const write_resp_bits_resp_;
   uint8_t* const write_resp_ready_;
 
-  std::queue<AxiAddr> addr_queue_;
-  std::queue<AxiWData> data_queue_;
-  std::map<uint8_t /*id*/, std::shared_ptr<bool>> outstanding_transactions_;
+  RingBuffer<AxiAddr, kAxiMaxOutstanding> addr_queue_;
+  RingBuffer<WriteBurst, kAxiMaxOutstanding> data_queue_;
+  AxiWData beat_;
+  bool beat_staged_ = false;
+  AxiBeatCounters counters_;
+  // Tags of unacknowledged bursts, indexed by AXI ID.
+  std::array<RingBuffer<uint64_t, kAxiMaxOutstanding>, kAxiNumIds>
+      outstanding_transactions_;
+  RingBuffer<AxiCompletion, kAxiMaxOutstanding> completions_;
+  uint64_t next_tag_ = 0;
+  size_t outstanding_count_ = 0;
 };
 
 // A driver to control interactions of the read channels in an AXI4 slave.
+// Like AxiSlaveWriteDriver, up to kAxiMaxOutstanding bursts may be
+// outstanding.
 class AxiSlaveReadDriver : Clock::Observer {
  public:
-  struct Transaction {
-    bool finished;
-    uint32_t start_addr;
-    uint32_t end_addr;
-    std::vector<uint8_t> data;
-  };
   AxiSlaveReadDriver(
       Clock* clock, uint8_t* read_addr_valid, uint32_t* read_addr_bits_addr,
       uint8_t* read_addr_bits_prot, uint8_t* read_addr_bits_id,
@@ -298,40 +494,112 @@ class AxiSlaveReadDriver : Clock::Observer {
     (*read_data_ready_) = 1;
   }
 
-  std::shared_ptr<Transaction> ReadTransaction(int id, uint32_t addr,
-                                               uint32_t byte_length) {
-    // Enqueue addr
-    AxiAddr axi_addr = AxiAddr::FromIdAddrSize(id, addr, byte_length);
-    addr_queue_.push(axi_addr);
+  // Queues a read burst. The data is written into `dest`, which must stay
+  // valid until the burst completes. Returns a tag identifying the burst in
+  // the completion queue.
+  uint64_t EnqueueRead(int id, uint32_t addr, absl::Span<uint8_t> dest) {
+    assert(CanEnqueue());
+    assert(id >= 0 && id < kAxiNumIds);
+    addr_queue_.push(AxiAddr::FromIdAddrSize(id, addr, dest.size()));
+    uint64_t tag = next_tag_++;
+    outstanding_transactions_[id].push({tag, addr, dest});
+    outstanding_count_++;
+    return tag;
+  }
+
+  // Whether another burst fits. Completions must be popped to free room.
+  bool CanEnqueue() const {
+    return outstanding_count_ + completions_.size() < kAxiMaxOutstanding;
+  }
 
-    // Enqueue data
-    assert(outstanding_transactions_.find(id) ==
-           outstanding_transactions_.end());
-    const auto [it, success] =
-        outstanding_transactions_.insert({id, std::make_shared<Transaction>()});
-    it->second->finished = false;
-    it->second->start_addr = addr;
-    it->second->end_addr = addr + byte_length;
-    it->second->data.reserve(byte_length);
-    return it->second;
+  // Pops the oldest completed burst. Returns false if there is none.
+  bool PopCompletion(AxiCompletion* completion) {
+    if (completions_.empty()) {
+      return false;
+    }
+    *completion = completions_.front();
+    completions_.pop();
+    return true;
   }
 
+  // Number of bursts issued but not yet fully received.
+  size_t outstanding() const { return outstanding_count_; }
+
+  // Read beats received and bytes taken from them.
+  AxiBeatCounters& counters() { return counters_; }
+  const AxiBeatCounters& counters() const { return counters_; }
+
  private:
+  struct PendingRead {
+    uint64_t tag;
+    uint32_t addr;
+    absl::Span<uint8_t> dest;
+  };
+
+  void Sample() final {
+    if (*read_addr_valid_ && *read_addr_ready_) {
+      addr_queue_.pop();
+    }
+    if (*read_data_valid_ && *read_data_ready_) {
+      ReceiveData();
+    }
+  }
+
+  void Drive() final {
+    *read_addr_valid_ = !addr_queue_.empty();
+    if (!addr_queue_.empty()) {
+      SetAddr(addr_queue_.front());
+    }
+  }
+
+  void SetAddr(const AxiAddr& addr) {
+    *read_addr_bits_addr_ = addr.addr_bits_addr;
+    *read_addr_bits_prot_ = addr.addr_bits_prot;
+    *read_addr_bits_id_ = addr.addr_bits_id;
+    *read_addr_bits_len_ = addr.addr_bits_len;
+    *read_addr_bits_size_ = addr.addr_bits_size;
+    *read_addr_bits_burst_ = addr.addr_bits_burst;
+    *read_addr_bits_lock_ = addr.addr_bits_lock;
+    *read_addr_bits_cache_ = addr.addr_bits_cache;
+    *read_addr_bits_qos_ = addr.addr_bits_qos;
+    *read_addr_bits_region_ = addr.addr_bits_region;
+  }
+
+  void ReceiveData() {
+    assert(*read_data_bits_resp_ == 0);
+
+    auto& outstanding = outstanding_transactions_[*read_data_bits_id_];
+    if (outstanding.empty()) {
+      return;
+    }
+    PendingRead& pending = outstanding.front();
+
+    // TODO(derekjchow): Should probably handle non-INCR mode.
+    uint32_t sub_addr = pending.addr % 16;
+    uint32_t bytes_to_read = 16 - sub_addr;
+    bytes_to_read =
+        std::min(bytes_to_read, static_cast<uint32_t>(pending.dest.size()));
+    const uint8_t* read_data =
+        reinterpret_cast<const uint8_t*>(&(*read_data_bits_data)[0]);
+    memcpy(pending.dest.data(), read_data + sub_addr, bytes_to_read);
+    counters_.beats++;
+    counters_.bytes += bytes_to_read;
+    pending.dest.remove_prefix(bytes_to_read);
+    pending.addr += bytes_to_read;
+    if (*read_data_bits_last_) {
+      completions_.push(
+          {pending.tag, *read_data_bits_id_, *read_data_bits_resp_});
+      outstanding.pop();
+      outstanding_count_--;
+    }
+  }
+
   void OnFallingEdge() final {
     // Send Addr
     *read_addr_valid_ = !addr_queue_.empty();
     clock().Eval();
     if (!addr_queue_.empty()) {
-      *read_addr_bits_addr_ = addr_queue_.front().addr_bits_addr;
-      *read_addr_bits_prot_ = addr_queue_.front().addr_bits_prot;
-      *read_addr_bits_id_ = addr_queue_.front().addr_bits_id;
-      *read_addr_bits_len_ = addr_queue_.front().addr_bits_len;
-      *read_addr_bits_size_ = addr_queue_.front().addr_bits_size;
-      *read_addr_bits_burst_ = addr_queue_.front().addr_bits_burst;
-      *read_addr_bits_lock_ = addr_queue_.front().addr_bits_lock;
-      *read_addr_bits_cache_ = addr_queue_.front().addr_bits_cache;
-      *read_addr_bits_qos_ = addr_queue_.front().addr_bits_qos;
-      *read_addr_bits_region_ = addr_queue_.front().addr_bits_region;
+      SetAddr(addr_queue_.front());
       if (*read_addr_ready_) {
         addr_queue_.pop();
       }
@@ -340,28 +608,7 @@ class AxiSlaveReadDriver : Clock::Observer {
 
     // Received data
     if (*read_data_valid_) {
-      assert(*read_data_bits_resp_ == 0);
-
-      auto it = outstanding_transactions_.find(*read_data_bits_id_);
-      if (it == outstanding_transactions_.end()) {
-        return;
-      }
-
-      // TODO(derekjchow): Should probably handle non-INCR mode.
-      uint32_t sub_addr = it->second->start_addr % 16;
-      uint32_t bytes_to_read = 16 - sub_addr;
-      bytes_to_read = std::min(bytes_to_read,
-                               it->second->end_addr - it->second->start_addr);
-      const uint8_t* read_data =
-          reinterpret_cast<const uint8_t*>(&(*read_data_bits_data)[0]);
-      for (uint32_t i = 0; i < bytes_to_read; i++) {
-        it->second->data.push_back(read_data[i + sub_addr]);
-      }
-      it->second->start_addr += bytes_to_read;
-      if (*read_data_bits_last_) {
-        it->second->finished = true;
-        outstanding_transactions_.erase(it);
-      }
+      ReceiveData();
     }
   }
 
@@ -387,9 +634,14 @@ class AxiSlaveReadDriver : Clock::Observer {
   const uint8_t* const read_data_bits_last_;
   uint8_t* const read_data_ready_;
 
-  std::queue<AxiAddr> addr_queue_;
-  std::map<uint8_t /*id*/, std::shared_ptr<Transaction>>
+  RingBuffer<AxiAddr, kAxiMaxOutstanding> addr_queue_;
+  // Bursts awaiting data, indexed by AXI ID.
+  std::array<RingBuffer<PendingRead, kAxiMaxOutstanding>, kAxiNumIds>
       outstanding_transactions_;
+  RingBuffer<AxiCompletion, kAxiMaxOutstanding> completions_;
+  uint64_t next_tag_ = 0;
+  size_t outstanding_count_ = 0;
+  AxiBeatCounters counters_;
 };
 
 // Struct representing the data transferred in an AXI4 read data channel.
@@ -400,7 +652,45 @@ struct AxiRData {
   uint8_t read_data_bits_last;
 };
 
+// Timing of the memory behind an AXI4 master port.
+struct AxiMasterTiming {
+  // Cycles between a read address being accepted and its first data beat.
+  uint32_t read_latency = 0;
+  // Average rate, in (0, 1], at which read beats are returned and write beats
+  // accepted. Each channel carries at most one beat per cycle.
+  double beats_per_cycle = 1.0;
+};
+
+// Throttles a channel to an average of AxiMasterTiming::beats_per_cycle.
+class AxiBeatThrottle {
+ public:
+  void set_beats_per_cycle(double beats_per_cycle) {
+    assert(beats_per_cycle > 0 && beats_per_cycle <= 1);
+    beats_per_cycle_ = beats_per_cycle;
+  }
+
+  // Called once per cycle.
+  void Tick() { credit_ = std::min(1.0, credit_ + beats_per_cycle_); }
+  bool CanSend() const { return credit_ >= 1.0; }
+  void Consume() { credit_ -= 1.0; }
+
+  void Save(VerilatedSerialize& os) const {
+    os.write(&credit_, sizeof(credit_));
+  }
+  void Restore(VerilatedDeserialize& is) {
+    is.read(&credit_, sizeof(credit_));
+  }
+
+ private:
+  double beats_per_cycle_ = 1.0;
+  double credit_ = 0;
+};
+
 // A driver to control interactions of the read channels in an AXI4 master.
+// Up to kAxiMaxOutstanding bursts, across any IDs, are accepted and answered
+// in the order they arrive. The read callback is invoked once per beat, as
+// the beat is sent, with addr_bits_addr set to that beat's address; the
+// driver fills in the ID and last flag of the data it returns.
 class AxiMasterReadDriver : Clock::Observer {
  public:
   AxiMasterReadDriver(
@@ -441,42 +731,123 @@ class AxiMasterReadDriver : Clock::Observer {
     read_cb_ = read_cb;
   }
 
+  void set_timing(const AxiMasterTiming& timing) {
+    read_latency_ = timing.read_latency;
+    throttle_.set_beats_per_cycle(timing.beats_per_cycle);
+  }
+
+  // Read beats served and bytes in them, by AxSIZE.
+  AxiBeatCounters& counters() { return counters_; }
+  const AxiBeatCounters& counters() const { return counters_; }
+
+  // True when no read address is being presented and no burst has beats left
+  // to send.
+  bool idle() const {
+    return !*read_addr_valid_ && bursts_.empty() && !beat_staged_;
+  }
+
+  // Checkpoint support: accepted bursts and the beat being presented.
+  void Save(VerilatedSerialize& os) const {
+    bursts_.Save(os);
+    os.write(&beat_, sizeof(beat_));
+    os.write(&beat_staged_, sizeof(beat_staged_));
+    os.write(&cycle_, sizeof(cycle_));
+    throttle_.Save(os);
+  }
+  void Restore(VerilatedDeserialize& is) {
+    bursts_.Restore(is);
+    is.read(&beat_, sizeof(beat_));
+    is.read(&beat_staged_, sizeof(beat_staged_));
+    is.read(&cycle_, sizeof(cycle_));
+    throttle_.Restore(is);
+  }
+
  private:
-  void OnFallingEdge() final {
-    // Send Data
-    *read_data_valid_ = !data_queue_.empty();
-    clock().Eval();
-    if (!data_queue_.empty()) {
-      *read_data_bits_data_ = data_queue_.front().read_data_bits_data;
-      *read_data_bits_id_ = data_queue_.front().read_data_bits_id;
-      *read_data_bits_resp_ = data_queue_.front().read_data_bits_resp;
-      *read_data_bits_last_ = data_queue_.front().read_data_bits_last;
-      if (*read_data_ready_) {
-        data_queue_.pop();
-      }
-      clock().Eval();
+  // An accepted burst that still has beats to send.
+  struct ReadBurst {
+    AxiAddr addr;
+    uint32_t next_beat;
+    // Driver cycle from which the first beat may be sent.
+    uint64_t ready_cycle;
+  };
+
+  void Sample() final {
+    if (*read_data_valid_ && *read_data_ready_) {
+      beat_staged_ = false;
+    }
+    if (*read_addr_valid_ && *read_addr_ready_) {
+      ReceiveAddr();
+    }
+  }
+
+  void Drive() final {
+    throttle_.Tick();
+    if (!beat_staged_ && !bursts_.empty() &&
+        bursts_.front().ready_cycle <= cycle_ && throttle_.CanSend()) {
+      StageBeat();
+      throttle_.Consume();
     }
+    cycle_++;
 
-    // Receive Address
-    if (*read_addr_valid_) {
-      axi_addr_.addr_bits_addr = *read_addr_bits_addr_;
-      axi_addr_.addr_bits_prot = *read_addr_bits_prot_;
-      axi_addr_.addr_bits_id = *read_addr_bits_id_;
-      axi_addr_.addr_bits_len = *read_addr_bits_len_;
-      axi_addr_.addr_bits_size = *read_addr_bits_size_;
-      axi_addr_.addr_bits_burst = *read_addr_bits_burst_;
-      axi_addr_.addr_bits_lock = *read_addr_bits_lock_;
-      axi_addr_.addr_bits_cache = *read_addr_bits_cache_;
-      axi_addr_.addr_bits_qos = *read_addr_bits_qos_;
-      axi_addr_.addr_bits_region = *read_addr_bits_region_;
-
-      if (read_cb_) {
-        AxiRData read_result = read_cb_(axi_addr_);
-        data_queue_.push(read_result);
-      } else {
-        assert(false && "Read callback is empty!");
-      }
+    *read_data_valid_ = beat_staged_;
+    if (beat_staged_) {
+      SetData(beat_);
     }
+    *read_addr_ready_ = !bursts_.full();
+  }
+
+  void SetData(const AxiRData& data) {
+    *read_data_bits_data_ = data.read_data_bits_data;
+    *read_data_bits_id_ = data.read_data_bits_id;
+    *read_data_bits_resp_ = data.read_data_bits_resp;
+    *read_data_bits_last_ = data.read_data_bits_last;
+  }
+
+  void ReceiveAddr() {
+    ReadBurst burst;
+    burst.addr.addr_bits_addr = *read_addr_bits_addr_;
+    burst.addr.addr_bits_prot = *read_addr_bits_prot_;
+    burst.addr.addr_bits_id = *read_addr_bits_id_;
+    burst.addr.addr_bits_len = *read_addr_bits_len_;
+    burst.addr.addr_bits_size = *read_addr_bits_size_;
+    burst.addr.addr_bits_burst = *read_addr_bits_burst_;
+    burst.addr.addr_bits_lock = *read_addr_bits_lock_;
+    burst.addr.addr_bits_cache = *read_addr_bits_cache_;
+    burst.addr.addr_bits_qos = *read_addr_bits_qos_;
+    burst.addr.addr_bits_region = *read_addr_bits_region_;
+    burst.next_beat = 0;
+    burst.ready_cycle = cycle_ + read_latency_;
+    bursts_.push(burst);
+  }
+
+  // Fetches the next beat of the oldest burst into `beat_`.
+  void StageBeat() {
+    ReadBurst& burst = bursts_.front();
+    AxiAddr beat_addr = burst.addr;
+    beat_addr.addr_bits_addr = burst.addr.BeatAddr(burst.next_beat);
+    if (read_cb_) {
+      beat_ = read_cb_(beat_addr);
+    } else {
+      assert(false && "Read callback is empty!");
+    }
+    beat_.read_data_bits_id = burst.addr.addr_bits_id;
+    beat_.read_data_bits_last = burst.next_beat == burst.addr.addr_bits_len;
+    counters_.beats++;
+    counters_.bytes += 1u << burst.addr.addr_bits_size;
+    if (beat_.read_data_bits_last) {
+      bursts_.pop();
+    } else {
+      burst.next_beat++;
+    }
+    beat_staged_ = true;
+  }
+
+  void OnFallingEdge() final {
+    // Present outputs, then complete whichever handshakes the model accepts
+    // on the coming rising edge.
+    Drive();
+    clock().Eval();
+    Sample();
   }
 
   // Signals
@@ -501,8 +872,13 @@ class AxiMasterReadDriver : Clock::Observer {
   uint8_t* const read_data_bits_last_;
   const uint8_t* const read_data_ready_;
 
-  std::queue<AxiRData> data_queue_;
-  AxiAddr axi_addr_;
+  RingBuffer<ReadBurst, kAxiMaxOutstanding> bursts_;
+  AxiRData beat_;
+  bool beat_staged_ = false;
+  uint64_t cycle_ = 0;
+  uint32_t read_latency_ = 0;
+  AxiBeatThrottle throttle_;
+  AxiBeatCounters counters_;
   std::function<AxiRData(const AxiAddr&)> read_cb_;
 };
 
@@ -512,7 +888,13 @@ struct AxiWResp {
   uint8_t write_resp_bits_resp;
 };
 
-// A driver to control interactions of the write channels in an AXI4 slave.
+// A driver to control interactions of the write channels in an AXI4 master.
+// Addresses and data are accepted independently; up to kAxiMaxOutstanding
+// addresses may be queued ahead of their data. Data beats are accepted once
+// the address of their burst is known, which AXI permits of a subordinate.
+// The write callback is invoked once per beat with addr_bits_addr set to that
+// beat's address, and a single response carrying the worst beat response is
+// returned after the last beat.
 class AxiMasterWriteDriver : Clock::Observer {
  public:
   AxiMasterWriteDriver(
@@ -561,55 +943,120 @@ class AxiMasterWriteDriver : Clock::Observer {
     write_cb_ = write_cb;
   }
 
+  // Only beats_per_cycle applies to writes.
+  void set_timing(const AxiMasterTiming& timing) {
+    throttle_.set_beats_per_cycle(timing.beats_per_cycle);
+  }
+
+  // Write beats accepted and bytes enabled in them.
+  AxiBeatCounters& counters() { return counters_; }
+  const AxiBeatCounters& counters() const { return counters_; }
+
+  // True when no write address or data is being presented, no burst is
+  // waiting for data and no response is queued.
+  bool idle() const {
+    return !*write_addr_valid_ && !*write_data_valid_ && bursts_.empty() &&
+           resp_queue_.empty();
+  }
+
+  // Checkpoint support: bursts awaiting data and responses not yet returned to
+  // the core.
+  void Save(VerilatedSerialize& os) const {
+    bursts_.Save(os);
+    resp_queue_.Save(os);
+    throttle_.Save(os);
+  }
+  void Restore(VerilatedDeserialize& is) {
+    bursts_.Restore(is);
+    resp_queue_.Restore(is);
+    throttle_.Restore(is);
+  }
+
  private:
-  void OnFallingEdge() final {
-    // Send Response
+  // An accepted burst that is still receiving data.
+  struct WriteBurst {
+    AxiAddr addr;
+    uint32_t next_beat;
+    uint8_t resp;
+  };
+
+  void Sample() final {
+    if (*write_resp_valid_ && *write_resp_ready_) {
+      resp_queue_.pop();
+    }
+    if (*write_data_valid_ && *write_data_ready_) {
+      ReceiveData();
+      throttle_.Consume();
+    }
+    if (*write_addr_valid_ && *write_addr_ready_) {
+      ReceiveAddr();
+    }
+  }
+
+  void Drive() final {
+    throttle_.Tick();
     *write_resp_valid_ = !resp_queue_.empty();
-    clock().Eval();
     if (!resp_queue_.empty()) {
       *write_resp_bits_id_ = resp_queue_.front().write_resp_bits_id;
       *write_resp_bits_resp_ = resp_queue_.front().write_resp_bits_resp;
-      if (*write_resp_ready_) {
-        resp_queue_.pop();
-      }
-      clock().Eval();
     }
+    *write_addr_ready_ = !bursts_.full();
+    *write_data_ready_ =
+        !bursts_.empty() && !resp_queue_.full() && throttle_.CanSend();
+  }
 
-    // Receive Addr
-    if (*write_addr_valid_) {
-      axi_addr_.addr_bits_addr = *write_addr_bits_addr_;
-      axi_addr_.addr_bits_prot = *write_addr_bits_prot_;
-      axi_addr_.addr_bits_id = *write_addr_bits_id_;
-      axi_addr_.addr_bits_len = *write_addr_bits_len_;
-      axi_addr_.addr_bits_size = *write_addr_bits_size_;
-      axi_addr_.addr_bits_burst = *write_addr_bits_burst_;
-      axi_addr_.addr_bits_lock = *write_addr_bits_lock_;
-      axi_addr_.addr_bits_cache = *write_addr_bits_cache_;
-      axi_addr_.addr_bits_qos = *write_addr_bits_qos_;
-      axi_addr_.addr_bits_region = *write_addr_bits_region_;
-    }
-    // Receive Data
-    if (*write_data_valid_) {
-      axi_data_.write_data_bits_data = *write_data_bits_data_;
-      axi_data_.write_data_bits_strb = *write_data_bits_strb_;
-      axi_data_.write_data_bits_last = *write_data_bits_last_;
-    }
-
-    if (*write_addr_valid_ && *write_data_valid_) {
-      *write_addr_ready_ = 1;
-      *write_data_ready_ = 1;
-      if (write_cb_) {
-        AxiWResp resp_result = write_cb_(axi_addr_, axi_data_);
-        resp_queue_.push(resp_result);
-      } else {
-        assert(false && "Write callback is empty!");
-      }
+  void ReceiveAddr() {
+    WriteBurst burst;
+    burst.addr.addr_bits_addr = *write_addr_bits_addr_;
+    burst.addr.addr_bits_prot = *write_addr_bits_prot_;
+    burst.addr.addr_bits_id = *write_addr_bits_id_;
+    burst.addr.addr_bits_len = *write_addr_bits_len_;
+    burst.addr.addr_bits_size = *write_addr_bits_size_;
+    burst.addr.addr_bits_burst = *write_addr_bits_burst_;
+    burst.addr.addr_bits_lock = *write_addr_bits_lock_;
+    burst.addr.addr_bits_cache = *write_addr_bits_cache_;
+    burst.addr.addr_bits_qos = *write_addr_bits_qos_;
+    burst.addr.addr_bits_region = *write_addr_bits_region_;
+    burst.next_beat = 0;
+    burst.resp = kAxiRespOkay;
+    bursts_.push(burst);
+  }
+
+  // Writes one beat of the oldest burst and, after its last beat, queues the
+  // burst's response.
+  void ReceiveData() {
+    WriteBurst& burst = bursts_.front();
+    AxiAddr beat_addr = burst.addr;
+    beat_addr.addr_bits_addr = burst.addr.BeatAddr(burst.next_beat);
+    AxiWData data;
+    data.write_data_bits_data = *write_data_bits_data_;
+    data.write_data_bits_strb = *write_data_bits_strb_;
+    data.write_data_bits_last = *write_data_bits_last_;
+    counters_.beats++;
+    counters_.bytes += __builtin_popcount(data.write_data_bits_strb);
+    if (write_cb_) {
+      AxiWResp beat_resp = write_cb_(beat_addr, data);
+      burst.resp = std::max(burst.resp, beat_resp.write_resp_bits_resp);
+    } else {
+      assert(false && "Write callback is empty!");
+    }
+    if (data.write_data_bits_last ||
+        burst.next_beat == burst.addr.addr_bits_len) {
+      resp_queue_.push({burst.addr.addr_bits_id, burst.resp});
+      bursts_.pop();
     } else {
-      *write_addr_ready_ = 0;
-      *write_data_ready_ = 0;
+      burst.next_beat++;
     }
   }
 
+  void OnFallingEdge() final {
+    // Present outputs, then complete whichever handshakes the model accepts
+    // on the coming rising edge.
+    Drive();
+    clock().Eval();
+    Sample();
+  }
+
   // Signals
   // WAddr
   const uint8_t* const write_addr_valid_;
@@ -636,9 +1083,10 @@ class AxiMasterWriteDriver : Clock::Observer {
   uint8_t* const write_resp_bits_resp_;
   const uint8_t* const write_resp_ready_;
 
-  std::queue<AxiWResp> resp_queue_;
-  AxiAddr axi_addr_;
-  AxiWData axi_data_;
+  RingBuffer<WriteBurst, kAxiMaxOutstanding> bursts_;
+  RingBuffer<AxiWResp, kAxiMasterQueueDepth> resp_queue_;
+  AxiBeatThrottle throttle_;
+  AxiBeatCounters counters_;
   std::function<AxiWResp(const AxiAddr&, const AxiWData&)> write_cb_;
 };
 
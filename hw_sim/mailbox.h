@@ -15,6 +15,15 @@
 #ifndef HW_SIM_MAILBOX_H_
 #define HW_SIM_MAILBOX_H_
 
+#include <cstdint>
+
+// Address of the mailbox on the core's AXI master port.
+constexpr uint32_t kCoralNPUMailboxAddr = 0x40000000;
+
+// Index of the doorbell word in CoralNPUMailbox::message. A core write to it
+// notifies the host and acknowledges (deasserts) the host's interrupt.
+constexpr int kCoralNPUDoorbellWord = 3;
+
 struct CoralNPUMailbox {
   uint32_t message[4] = {0, 0, 0, 0};
 };
@@ -0,0 +1,58 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HW_SIM_PERF_COUNTERS_H_
+#define HW_SIM_PERF_COUNTERS_H_
+
+#include <cstdint>
+
+// Dispatch lanes of the scalar core (instructionLanes in Parameters.scala).
+constexpr int kCoralNPUDispatchLanes = 4;
+
+// Traffic through one direction of an AXI port.
+struct CoralNPUAxiTraffic {
+  uint64_t beats = 0;
+  uint64_t bytes = 0;
+};
+
+// Counters accumulated by the simulator since construction. Take the
+// difference of two snapshots to cost a job.
+struct CoralNPUPerfCounters {
+  // All clock cycles, including those fast-forwarded by idle skip.
+  uint64_t cycles = 0;
+  // Cycles the core was neither in WFI nor halted.
+  uint64_t active_cycles = 0;
+  uint64_t wfi_cycles = 0;
+  uint64_t halted_cycles = 0;
+  // Instructions issued by each dispatch lane (io_debug_dispatch_*_instFire).
+  // The models have no retirement port, so this counts dispatch, which
+  // includes instructions later squashed by a fault.
+  uint64_t dispatch_fires[kCoralNPUDispatchLanes] = {};
+  // Slave port: host accesses to the TCMs and CSRs.
+  CoralNPUAxiTraffic slave_read;
+  CoralNPUAxiTraffic slave_write;
+  // Master port: core accesses to the mailbox and external memory.
+  CoralNPUAxiTraffic master_read;
+  CoralNPUAxiTraffic master_write;
+
+  uint64_t instructions_dispatched() const {
+    uint64_t instructions = 0;
+    for (uint64_t fires : dispatch_fires) {
+      instructions += fires;
+    }
+    return instructions;
+  }
+};
+
+#endif  // HW_SIM_PERF_COUNTERS_H_
@@ -0,0 +1,104 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Loads and runs the mobilenet tutorial through the Python bindings.
+
+Prints the same load/run times and cycle counts as the cocotb version,
+tests/cocotb/tutorial/tfmicro/cocotb_run_mobilenet_v1.py, so the two can be
+compared directly.
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+from bazel_tools.tools.python.runfiles import runfiles
+from hw_sim import coralnpu_simulator_rvv_highmem_py as coralnpu_simulator
+
+_ELF = ("coralnpu_hw/tests/cocotb/tutorial/tfmicro/"
+        "run_mobilenet_v1_025_partial_binary.elf")
+
+
+def run_once(elf_path, symbols, mode, timeout_cycles):
+    """Runs one inference on a fresh simulator and returns its timings."""
+    start = time.perf_counter()
+    simulator = coralnpu_simulator.Simulator()
+    created = time.perf_counter()
+    simulator.set_tcm_access_mode(mode)
+    entry_point = simulator.load_elf(elf_path)
+    loaded = time.perf_counter()
+    load_cycles = simulator.get_cycle_count()
+    simulator.run(entry_point)
+    terminated = simulator.wait_for_termination(timeout_cycles)
+    finished = time.perf_counter()
+
+    status = simulator.read_tcm(symbols["inference_status"], 1)
+    status = status.view(np.int8)[0]
+    message = simulator.read_tcm(symbols["inference_status_message"], 31)
+    message = bytes(message).split(b"\0")[0].decode()
+    if not terminated or status != 0:
+        raise RuntimeError(f"Inference failed: {message}")
+    perf = simulator.read_perf_counters()
+    return {
+        "create_s": created - start,
+        "load_s": loaded - created,
+        "run_s": finished - loaded,
+        "load_cycles": load_cycles,
+        "run_cycles": perf["cycles"] - load_cycles,
+        "instructions": sum(perf["dispatch_fires"]),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--iterations", type=int, default=3,
+                        help="Number of inferences, each on a new simulator.")
+    parser.add_argument("--mode", choices=["axi", "backdoor"], default="axi",
+                        help="How the ELF is written to the TCMs.")
+    parser.add_argument("--timeout_cycles", type=int, default=130_000_000,
+                        help="Cycle budget for one inference.")
+    args = parser.parse_args()
+
+    r = runfiles.Create()
+    elf_path = r.Rlocation(_ELF)
+    symbols = {}
+    for symbol in ["inference_status", "inference_status_message"]:
+        symbols[symbol] = coralnpu_simulator.lookup_symbol(elf_path, symbol)
+        if symbols[symbol] is None:
+            raise RuntimeError(f"{symbol} not found in {elf_path}")
+    modes = coralnpu_simulator.TCMAccessMode
+    mode = modes.BACKDOOR if args.mode == "backdoor" else modes.AXI
+
+    results = []
+    for i in range(args.iterations):
+        result = run_once(elf_path, symbols, mode, args.timeout_cycles)
+        results.append(result)
+        print(f"Iteration {i}: load {result['load_s']:.3f} s "
+              f"({result['load_cycles']} cycles), run {result['run_s']:.3f} s "
+              f"({result['run_cycles']} cycles)", flush=True)
+
+    run_s = np.median([r["run_s"] for r in results])
+    load_s = np.median([r["load_s"] for r in results])
+    create_s = np.median([r["create_s"] for r in results])
+    run_cycles = results[-1]["run_cycles"]
+    print(f"Median create: {create_s:.3f} s, load ({args.mode}): "
+          f"{load_s:.3f} s, run: {run_s:.3f} s")
+    print(f"Total number of execution cycles: {run_cycles}, "
+          f"instructions: {results[-1]['instructions']}, "
+          f"{run_cycles / run_s:.0f} cycles/s")
+
+
+if __name__ == "__main__":
+    main()
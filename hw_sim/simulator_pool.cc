@@ -0,0 +1,140 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hw_sim/simulator_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "hw_sim/elf_loader.h"
+
+SimulatorPool::SimulatorPool(int num_threads, bool pin_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(
+        [this, i, pin_threads]() { WorkerLoop(i, pin_threads); });
+  }
+}
+
+SimulatorPool::~SimulatorPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<SimulatorJobResult> SimulatorPool::Submit(SimulatorJob job) {
+  PendingJob pending;
+  pending.job = std::move(job);
+  std::future<SimulatorJobResult> result = pending.promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(pending));
+  }
+  cv_.notify_one();
+  return result;
+}
+
+// static
+std::shared_ptr<const std::vector<uint8_t>> SimulatorPool::ReadFile(
+    const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  return std::make_shared<const std::vector<uint8_t>>(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void SimulatorPool::WorkerLoop(int index, bool pin_thread) {
+  if (pin_thread) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(index % std::thread::hardware_concurrency(), &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  }
+
+  // Created on the worker so that the model and its context are only ever
+  // touched from this thread.
+  std::unique_ptr<CoralNPUSimulator> simulator(CoralNPUSimulator::Create());
+  while (true) {
+    PendingJob pending;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return shutdown_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      pending = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    SimulatorJobResult result = RunJob(simulator.get(), pending.job);
+    const bool terminated = result.terminated;
+    pending.promise.set_value(std::move(result));
+    // A job that timed out leaves the core running its program, which
+    // would race the next job's loads. Start the next job on a fresh
+    // simulator instead.
+    if (!terminated) {
+      simulator.reset(CoralNPUSimulator::Create());
+    }
+  }
+}
+
+// static
+SimulatorJobResult SimulatorPool::RunJob(CoralNPUSimulator* simulator,
+                                         const SimulatorJob& job) {
+  SimulatorJobResult result;
+  const uint64_t start_cycles = simulator->GetCycleCount();
+
+  // Clear anything the previous job left in the mailbox.
+  simulator->WriteMailbox(CoralNPUMailbox());
+
+  uint32_t start_pc = LoadElfIntoSimulator(simulator, job.elf->data());
+  for (const auto& input : job.inputs) {
+    simulator->WriteTCM(input.addr, input.data.size(),
+                        reinterpret_cast<const char*>(input.data.data()));
+  }
+
+  simulator->Run(start_pc);
+  result.terminated = simulator->WaitForTermination(job.timeout);
+  result.passed = result.terminated;
+
+  result.mailbox = simulator->ReadMailbox();
+  if (job.expected_mailbox.has_value() &&
+      memcmp(result.mailbox.message, job.expected_mailbox->message,
+             sizeof(result.mailbox.message)) != 0) {
+    result.passed = false;
+  }
+
+  for (const auto& output : job.outputs) {
+    std::vector<uint8_t> data(output.size);
+    simulator->ReadTCM(output.addr, output.size,
+                       reinterpret_cast<char*>(data.data()));
+    if (!output.expected.empty() && output.expected != data) {
+      result.passed = false;
+    }
+    result.outputs.push_back(std::move(data));
+  }
+
+  result.cycles = simulator->GetCycleCount() - start_cycles;
+  return result;
+}
@@ -0,0 +1,111 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HW_SIM_SIMULATOR_POOL_H_
+#define HW_SIM_SIMULATOR_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/mailbox.h"
+
+// Bytes written to TCM before a job starts.
+struct SimulatorInput {
+  uint32_t addr;
+  std::vector<uint8_t> data;
+};
+
+// A TCM range read back after a job terminates. If `expected` is non-empty
+// the data read must match it for the job to pass.
+struct SimulatorOutput {
+  uint32_t addr;
+  size_t size;
+  std::vector<uint8_t> expected;
+};
+
+struct SimulatorJob {
+  // ELF image to load. Shared so that many jobs can run the same program
+  // without copying it.
+  std::shared_ptr<const std::vector<uint8_t>> elf;
+  std::vector<SimulatorInput> inputs;
+  std::vector<SimulatorOutput> outputs;
+  // If set, the mailbox must match it for the job to pass.
+  std::optional<CoralNPUMailbox> expected_mailbox;
+  // Cycles to wait for WFI or halt, as in CoralNPUSimulator::WaitForTermination.
+  int timeout = 10000;
+};
+
+struct SimulatorJobResult {
+  // Whether the core reached WFI or halted within the timeout.
+  bool terminated = false;
+  // Terminated and every expectation in the job matched.
+  bool passed = false;
+  CoralNPUMailbox mailbox;
+  // Data read for each SimulatorJob::outputs entry, in order.
+  std::vector<std::vector<uint8_t>> outputs;
+  // Cycles simulated for this job, including loading inputs.
+  uint64_t cycles = 0;
+};
+
+// Runs jobs on a fixed set of independent simulators. Each worker thread
+// creates and owns one CoralNPUSimulator (and so one VerilatedContext),
+// replacing it only after a job times out; jobs are taken from a shared
+// queue in submission order.
+class SimulatorPool {
+ public:
+  // Starts `num_threads` workers. With `pin_threads`, worker i is bound to
+  // host CPU i modulo the number of CPUs.
+  explicit SimulatorPool(int num_threads, bool pin_threads = false);
+  // Finishes all submitted jobs before returning.
+  ~SimulatorPool();
+
+  SimulatorPool(const SimulatorPool&) = delete;
+  SimulatorPool& operator=(const SimulatorPool&) = delete;
+
+  std::future<SimulatorJobResult> Submit(SimulatorJob job);
+
+  int size() const { return static_cast<int>(workers_.size()); }
+
+  // Reads a whole file, e.g. an ELF, for use as SimulatorJob::elf. Returns
+  // nullptr if it cannot be read.
+  static std::shared_ptr<const std::vector<uint8_t>> ReadFile(
+      const std::string& path);
+
+ private:
+  struct PendingJob {
+    SimulatorJob job;
+    std::promise<SimulatorJobResult> promise;
+  };
+
+  void WorkerLoop(int index, bool pin_thread);
+  static SimulatorJobResult RunJob(CoralNPUSimulator* simulator,
+                                   const SimulatorJob& job);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<PendingJob> jobs_;
+  bool shutdown_ = false;
+  std::vector<std::thread> workers_;
+};
+
+#endif  // HW_SIM_SIMULATOR_POOL_H_
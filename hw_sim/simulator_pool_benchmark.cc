@@ -0,0 +1,87 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the same program many times through a SimulatorPool at increasing
+// thread counts and reports aggregate simulated cycles per host second.
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/simulator_pool.h"
+
+ABSL_FLAG(std::string, binary, "hw_sim/mailbox_example.elf",
+          "Binary to execute");
+ABSL_FLAG(int, jobs_per_thread, 16, "Jobs submitted per worker thread");
+ABSL_FLAG(int, max_threads, 0,
+          "Largest thread count to measure; 0 uses all host CPUs");
+ABSL_FLAG(bool, pin_threads, true, "Pin each worker to a host CPU");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  const std::string file_name = absl::GetFlag(FLAGS_binary);
+  auto elf = SimulatorPool::ReadFile(file_name);
+  if (elf == nullptr) {
+    std::cout << "Failed to open " << file_name << std::endl;
+    return -1;
+  }
+  int max_threads = absl::GetFlag(FLAGS_max_threads);
+  if (max_threads <= 0) {
+    max_threads = std::thread::hardware_concurrency();
+  }
+
+  double single_thread_rate = 0;
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    SimulatorPool pool(threads, absl::GetFlag(FLAGS_pin_threads));
+    const int num_jobs = threads * absl::GetFlag(FLAGS_jobs_per_thread);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<SimulatorJobResult>> results;
+    for (int i = 0; i < num_jobs; i++) {
+      SimulatorJob job;
+      job.elf = elf;
+      results.push_back(pool.Submit(std::move(job)));
+    }
+    uint64_t cycles = 0;
+    int failed = 0;
+    for (auto& result : results) {
+      SimulatorJobResult job_result = result.get();
+      cycles += job_result.cycles;
+      if (!job_result.passed) {
+        failed++;
+      }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    double rate = cycles / std::chrono::duration<double>(end - start).count();
+    if (threads == 1) {
+      single_thread_rate = rate;
+    }
+    std::cout << "threads: " << threads << " jobs: " << num_jobs
+              << " failed: " << failed << " cycles/s: " << rate
+              << " scaling: " << rate / single_thread_rate << "x"
+              << std::endl;
+    if (failed != 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
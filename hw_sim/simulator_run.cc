@@ -0,0 +1,99 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs one ELF to termination on a simulator library loaded with dlopen(),
+// the way external projects consume libcoralnpu_simulator*.so, and reports
+// the same statistics as core_mini_axi_sim --stats_json.
+
+#include <dlfcn.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+ABSL_FLAG(std::string, library, "hw_sim/libcoralnpu_simulator.so",
+          "Simulator library to load");
+ABSL_FLAG(std::string, binary, "", "Binary to execute");
+ABSL_FLAG(int, cycles, 100000000, "Cycles to run before giving up");
+ABSL_FLAG(std::string, stats_json, "",
+          "Write cycles, ELF load time and run time as JSON to this path");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const std::string library = absl::GetFlag(FLAGS_library);
+  const std::string file_name = absl::GetFlag(FLAGS_binary);
+
+  void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle == nullptr) {
+    std::cout << "Failed to load " << library << ": " << dlerror()
+              << std::endl;
+    return -1;
+  }
+  auto create = reinterpret_cast<CoralNPUSimulatorCreateFn>(
+      dlsym(handle, "CoralNPUSimulatorCreate"));
+  if (create == nullptr) {
+    std::cout << library << " has no CoralNPUSimulatorCreate" << std::endl;
+    dlclose(handle);
+    return -1;
+  }
+
+  MappedElf elf;
+  if (!elf.Open(file_name)) {
+    dlclose(handle);
+    return -1;
+  }
+
+  std::unique_ptr<CoralNPUSimulator> simulator(create());
+  const auto start = std::chrono::steady_clock::now();
+  uint32_t start_pc = LoadElfIntoSimulator(simulator.get(), elf);
+  const auto loaded = std::chrono::steady_clock::now();
+
+  const uint64_t load_cycles = simulator->GetCycleCount();
+  simulator->Run(start_pc);
+  bool halted = simulator->WaitForTermination(absl::GetFlag(FLAGS_cycles));
+  const auto finished = std::chrono::steady_clock::now();
+  const uint64_t cycles = simulator->GetCycleCount() - load_cycles;
+  simulator.reset();
+  dlclose(handle);
+
+  const std::string stats_json = absl::GetFlag(FLAGS_stats_json);
+  if (!stats_json.empty()) {
+    FILE* f = fopen(stats_json.c_str(), "w");
+    if (f == nullptr) {
+      std::cout << "Failed to open " << stats_json << std::endl;
+      return -1;
+    }
+    fprintf(f,
+            "{\"library\": \"%s\", \"binary\": \"%s\", \"halted\": %s, "
+            "\"cycles\": %lu, \"load_seconds\": %.6f, \"run_seconds\": %.6f}\n",
+            library.c_str(), file_name.c_str(), halted ? "true" : "false",
+            static_cast<unsigned long>(cycles),
+            std::chrono::duration<double>(loaded - start).count(),
+            std::chrono::duration<double>(finished - loaded).count());
+    fclose(f);
+  }
+  if (!halted) {
+    std::cout << "Cycle limit reached before the core halted" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,151 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Measures simulator throughput over a fixed corpus of programs.
+
+Each program runs in its own process on both core_mini_axi_sim (SystemC) and
+hw_sim (libcoralnpu_simulator*.so through simulator_run). For every run the
+results record wall time, simulated cycles, cycles per second, peak RSS and
+ELF load time, written as JSON for regression tracking.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+from bazel_tools.tools.python.runfiles import runfiles
+
+# Simulator binaries for each core model: (core_mini_axi_sim, hw_sim library).
+_MODELS = {
+    "core_mini_axi": (
+        "tests/verilator_sim/core_mini_axi_sim",
+        "hw_sim/libcoralnpu_simulator.so",
+    ),
+    "rvv_core_mini_axi": (
+        "tests/verilator_sim/rvv_core_mini_axi_sim",
+        "hw_sim/libcoralnpu_simulator_rvv.so",
+    ),
+    "rvv_core_mini_highmem_axi": (
+        "tests/verilator_sim/rvv_core_mini_highmem_axi_sim",
+        "hw_sim/libcoralnpu_simulator_rvv_highmem.so",
+    ),
+}
+
+# (name, ELF, model, cycle limit, whether the program halts on its own).
+# stress_test loops until the host sets `halt`, so it is measured over a
+# fixed number of cycles instead.
+_CORPUS = [
+    ("noop", "tests/cocotb/noop.elf", "core_mini_axi", 100_000, True),
+    ("stress_test", "tests/cocotb/stress_test.elf", "core_mini_axi",
+     1_000_000, False),
+    ("rvv_matmul", "tests/cocotb/rvv/ml_ops/rvv_matmul.elf",
+     "rvv_core_mini_axi", 10_000_000, True),
+    ("depthwise_conv",
+     "tests/cocotb/tutorial/tfmicro/depthwise_conv_test.elf",
+     "rvv_core_mini_highmem_axi", 50_000_000, True),
+    ("mobilenet",
+     "tests/cocotb/tutorial/tfmicro/run_mobilenet_v1_025_partial_binary.elf",
+     "rvv_core_mini_highmem_axi", 200_000_000, True),
+]
+
+_SIMULATORS = ["core_mini_axi_sim", "hw_sim"]
+
+
+def run_program(r, simulator, name, elf, model, cycles, halts):
+    """Runs one program in a child process and returns its result record."""
+    sim_binary, library = _MODELS[model]
+    elf_path = r.Rlocation("coralnpu_hw/" + elf)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        stats_path = os.path.join(tmpdir, "stats.json")
+        if simulator == "core_mini_axi_sim":
+            cmd = [r.Rlocation("coralnpu_hw/" + sim_binary),
+                   f"--binary={elf_path}", f"--cycles={cycles}"]
+        else:
+            cmd = [r.Rlocation("coralnpu_hw/hw_sim/simulator_run"),
+                   f"--library={r.Rlocation('coralnpu_hw/' + library)}",
+                   f"--binary={elf_path}", f"--cycles={cycles}"]
+        cmd.append(f"--stats_json={stats_path}")
+
+        start = time.perf_counter()
+        process = subprocess.Popen(cmd, stdout=subprocess.DEVNULL)
+        _, status, rusage = os.wait4(process.pid, 0)
+        wall_seconds = time.perf_counter() - start
+        exit_code = os.waitstatus_to_exitcode(status)
+        try:
+            with open(stats_path) as f:
+                stats = json.load(f)
+        except (OSError, ValueError):
+            stats = {}
+
+    halted = stats.get("halted", False)
+    passed = halted == halts and (exit_code == 0 or not halts)
+    run_seconds = stats.get("run_seconds", 0.0)
+    sim_cycles = stats.get("cycles", 0)
+    return {
+        "program": name,
+        "simulator": simulator,
+        "model": model,
+        "passed": passed,
+        "halted": halted,
+        "wall_seconds": wall_seconds,
+        "load_seconds": stats.get("load_seconds", 0.0),
+        "run_seconds": run_seconds,
+        "cycles": sim_cycles,
+        "cycles_per_second": sim_cycles / run_seconds if run_seconds else 0.0,
+        # ru_maxrss is in KiB on Linux.
+        "peak_rss_bytes": rusage.ru_maxrss * 1024,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--output", default="",
+                        help="Write the JSON report here instead of stdout.")
+    parser.add_argument("--programs", nargs="*",
+                        default=[c[0] for c in _CORPUS],
+                        help="Subset of the corpus to run.")
+    parser.add_argument("--simulators", nargs="*", default=_SIMULATORS,
+                        choices=_SIMULATORS,
+                        help="Simulators to measure.")
+    args = parser.parse_args()
+
+    r = runfiles.Create()
+    results = []
+    for name, elf, model, cycles, halts in _CORPUS:
+        if name not in args.programs:
+            continue
+        for simulator in args.simulators:
+            result = run_program(r, simulator, name, elf, model, cycles, halts)
+            results.append(result)
+            print(f"{name:16} {simulator:18} {result['cycles']:>12} cycles "
+                  f"{result['cycles_per_second']:>12.0f} cycles/s "
+                  f"{result['peak_rss_bytes'] >> 20:>6} MiB "
+                  f"{'ok' if result['passed'] else 'FAILED'}",
+                  file=sys.stderr, flush=True)
+
+    report = json.dumps({"results": results}, indent=2)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(report + "\n")
+    else:
+        print(report)
+    return 0 if all(result["passed"] for result in results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,63 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Streams data into DTCM through the AXI slave port and reports the host time
+// spent per 16-byte beat.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/core_mini_axi_wrapper.h"
+
+ABSL_FLAG(int, mib, 64, "MiB to write through the slave port");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  constexpr uint32_t kBeatBytes = 16;
+
+  VerilatedContext context;
+  CoreMiniAxiWrapper wrapper(&context);
+  wrapper.Reset();
+
+  std::vector<uint8_t> buffer(kDtcmSizeBytes);
+  for (uint32_t i = 0; i < kDtcmSizeBytes; i++) {
+    buffer[i] = static_cast<uint8_t>(i);
+  }
+
+  const uint64_t total_bytes = static_cast<uint64_t>(absl::GetFlag(FLAGS_mib))
+                               << 20;
+  const uint64_t start_cycles = wrapper.cycles();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint64_t written = 0; written < total_bytes; written += kDtcmSizeBytes) {
+    wrapper.Write(kDtcmAddr, kDtcmSizeBytes,
+                  reinterpret_cast<const char*>(buffer.data()));
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const uint64_t beats = total_bytes / kBeatBytes;
+  const uint64_t cycles = wrapper.cycles() - start_cycles;
+  const double ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << "bytes: " << total_bytes << std::endl;
+  std::cout << "beats: " << beats << std::endl;
+  std::cout << "simulated cycles: " << cycles << std::endl;
+  std::cout << "host ns/beat: " << ns / beats << std::endl;
+  std::cout << "host ns/cycle: " << ns / cycles << std::endl;
+  return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HW_SIM_TCM_BACKDOOR_H_
+#define HW_SIM_TCM_BACKDOOR_H_
+
+// simutil_{get,set}_mem are declared by the verilated model's __Dpi.h, which
+// must be included before this header.
+#include <svdpi.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+// Direct access to the generic SRAM macros backing a TCM, through the DPI
+// functions exported by hdl/verilog/Sram_*x128.v. Accesses take no simulated
+// time and never touch the AXI fabric.
+class TcmBackdoor {
+ public:
+  // `scope` is the hierarchical name of the TCM128 instance, `base_addr` and
+  // `size_bytes` its location in the core's address map.
+  TcmBackdoor(const std::string& scope, uint32_t base_addr,
+              uint32_t size_bytes)
+      : base_addr_(base_addr), size_bytes_(size_bytes) {
+    // Mirrors the macro selection in Sram_Nx128.
+    uint32_t entries = size_bytes / kLineBytes;
+    if (entries % 2048 == 0) {
+      entries_per_macro_ = 2048;
+    } else if (entries % 512 == 0) {
+      entries_per_macro_ = 512;
+    } else {
+      entries_per_macro_ = 128;
+    }
+    for (uint32_t i = 0; i < entries / entries_per_macro_; i++) {
+      std::string name = scope + ".sram.sramModules_" + std::to_string(i);
+      svScope macro = svGetScopeFromName(name.c_str());
+      assert(macro != nullptr && "TCM SRAM scope not found");
+      macros_.push_back(macro);
+    }
+  }
+
+  bool Contains(uint32_t addr, uint32_t len) const {
+    return addr >= base_addr_ && len <= size_bytes_ &&
+           (addr - base_addr_) <= (size_bytes_ - len);
+  }
+
+  void Write(uint32_t addr, absl::Span<const uint8_t> data) {
+    assert(Contains(addr, data.size()));
+    uint32_t offset = addr - base_addr_;
+    while (data.size() > 0) {
+      uint32_t line = offset / kLineBytes;
+      uint32_t sub_addr = offset % kLineBytes;
+      uint32_t bytes = std::min(static_cast<uint32_t>(data.size()),
+                                kLineBytes - sub_addr);
+      svBitVecVal value[kDpiWords] = {};
+      if (bytes != kLineBytes) {
+        GetLine(line, value);
+      }
+      memcpy(reinterpret_cast<uint8_t*>(value) + sub_addr, data.data(), bytes);
+      SetLine(line, value);
+      data.remove_prefix(bytes);
+      offset += bytes;
+    }
+  }
+
+  void Read(uint32_t addr, absl::Span<uint8_t> data) {
+    assert(Contains(addr, data.size()));
+    uint32_t offset = addr - base_addr_;
+    while (data.size() > 0) {
+      uint32_t line = offset / kLineBytes;
+      uint32_t sub_addr = offset % kLineBytes;
+      uint32_t bytes = std::min(static_cast<uint32_t>(data.size()),
+                                kLineBytes - sub_addr);
+      svBitVecVal value[kDpiWords];
+      GetLine(line, value);
+      memcpy(data.data(), reinterpret_cast<uint8_t*>(value) + sub_addr, bytes);
+      data.remove_prefix(bytes);
+      offset += bytes;
+    }
+  }
+
+ private:
+  static constexpr uint32_t kLineBytes = 16;
+  // simutil_{get,set}_mem use the 312-bit vectors of prim_util_memload.svh.
+  static constexpr int kDpiWords = 10;
+
+  void SetLine(uint32_t line, const svBitVecVal* value) {
+    svSetScope(macros_[line / entries_per_macro_]);
+    simutil_set_mem(line % entries_per_macro_, value);
+  }
+
+  void GetLine(uint32_t line, svBitVecVal* value) {
+    svSetScope(macros_[line / entries_per_macro_]);
+    simutil_get_mem(line % entries_per_macro_, value);
+  }
+
+  const uint32_t base_addr_;
+  const uint32_t size_bytes_;
+  uint32_t entries_per_macro_;
+  std::vector<svScope> macros_;
+};
+
+#endif  // HW_SIM_TCM_BACKDOOR_H_
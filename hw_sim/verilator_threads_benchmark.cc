@@ -0,0 +1,152 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports simulated kHz of the RVV programs for each verilator --threads
+// build of the simulator library. The single- and multithreaded models
+// define the same symbols, so each library is dlopen()ed privately rather
+// than linked.
+
+#include <dlfcn.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "hw_sim/coralnpu_simulator.h"
+#include "hw_sim/elf_loader.h"
+
+ABSL_FLAG(std::vector<std::string>, threads,
+          std::vector<std::string>({"1", "2", "4", "8"}),
+          "Verilator thread counts to compare");
+ABSL_FLAG(int, repeats, 3, "Runs per program and thread count; best is kept");
+ABSL_FLAG(int, timeout, 50000000, "Cycle budget for one run");
+
+namespace {
+
+struct Program {
+  const char* name;
+  // Simulator library variant, as in libcoralnpu_simulator_<variant>.so.
+  const char* variant;
+  const char* elf;
+};
+
+constexpr Program kPrograms[] = {
+    {"rvv_matmul", "rvv", "tests/cocotb/rvv/ml_ops/rvv_matmul.elf"},
+    {"depthwise_conv", "rvv_highmem",
+     "tests/cocotb/tutorial/tfmicro/depthwise_conv_test.elf"},
+};
+
+std::string LibraryPath(const std::string& variant, int threads) {
+  std::string path = "hw_sim/libcoralnpu_simulator_" + variant;
+  if (threads > 1) {
+    path += "_threads" + std::to_string(threads);
+  }
+  return path + ".so";
+}
+
+// Loads `path` and returns its create function, or nullptr. On success
+// `*handle` must be dlclose()d once every simulator it created is destroyed.
+CoralNPUSimulatorCreateFn LoadLibrary(const std::string& path, void** handle) {
+  *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (*handle == nullptr) {
+    std::cout << "Failed to load " << path << ": " << dlerror() << std::endl;
+    return nullptr;
+  }
+  auto create = reinterpret_cast<CoralNPUSimulatorCreateFn>(
+      dlsym(*handle, "CoralNPUSimulatorCreate"));
+  if (create == nullptr) {
+    std::cout << path << " has no CoralNPUSimulatorCreate" << std::endl;
+    dlclose(*handle);
+    *handle = nullptr;
+  }
+  return create;
+}
+
+struct RunResult {
+  bool terminated = false;
+  uint64_t cycles = 0;
+  double seconds = 0;
+};
+
+RunResult RunOnce(CoralNPUSimulatorCreateFn create, const MappedElf& elf,
+                  int timeout) {
+  std::unique_ptr<CoralNPUSimulator> simulator(create());
+  simulator->SetTCMAccessMode(TCMAccessMode::kBackdoor);
+  uint32_t start_pc = LoadElfIntoSimulator(simulator.get(), elf);
+
+  RunResult result;
+  const uint64_t start_cycles = simulator->GetCycleCount();
+  const auto start = std::chrono::steady_clock::now();
+  simulator->Run(start_pc);
+  result.terminated = simulator->WaitForTermination(timeout);
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  result.cycles = simulator->GetCycleCount() - start_cycles;
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const int repeats = absl::GetFlag(FLAGS_repeats);
+  const int timeout = absl::GetFlag(FLAGS_timeout);
+
+  printf("%-16s %8s %12s %10s %10s %8s\n", "program", "threads", "cycles",
+         "seconds", "kHz", "speedup");
+  for (const Program& program : kPrograms) {
+    MappedElf elf;
+    if (!elf.Open(program.elf)) {
+      return -1;
+    }
+
+    double single_thread_khz = 0;
+    for (const std::string& threads_flag : absl::GetFlag(FLAGS_threads)) {
+      const int threads = std::stoi(threads_flag);
+      void* handle;
+      CoralNPUSimulatorCreateFn create =
+          LoadLibrary(LibraryPath(program.variant, threads), &handle);
+      if (create == nullptr) {
+        return -1;
+      }
+      RunResult best;
+      for (int i = 0; i < repeats; i++) {
+        RunResult result = RunOnce(create, elf, timeout);
+        if (i == 0 || result.seconds < best.seconds) {
+          best = result;
+        }
+      }
+      // RunOnce() destroys its simulator, so nothing refers to the library.
+      dlclose(handle);
+      const double khz = best.cycles / best.seconds / 1000.0;
+      if (threads == 1) {
+        single_thread_khz = khz;
+      }
+      printf("%-16s %8d %12lu %10.3f %10.1f", program.name, threads,
+             static_cast<unsigned long>(best.cycles), best.seconds, khz);
+      if (single_thread_khz > 0) {
+        printf(" %7.2fx", khz / single_thread_khz);
+      }
+      printf("%s\n", best.terminated ? "" : " (timed out)");
+    }
+  }
+  return 0;
+}
@@ -127,6 +127,9 @@ def chisel_test(
         size = size,
     )
 
+# Thread counts built by chisel_cc_library(threads = VERILATOR_THREADS).
+VERILATOR_THREADS = [2, 4, 8]
+
 def chisel_cc_library(
         name,
         chisel_lib,
@@ -136,7 +139,8 @@ def chisel_cc_library(
         verilog_file_path = "",
         vopts = [],
         gen_flags = [],
-        extra_outs = []):
+        extra_outs = [],
+        threads = []):
     gen_binary_name = name + "_emit_verilog_binary"
     chisel_binary(
         name = gen_binary_name,
@@ -188,3 +192,25 @@ def chisel_cc_library(
         vopts = vopts + ["--pins-bv", "2"],
         systemc = False,
     )
+
+    # Multithreaded variants of both, verilated with --threads N and named
+    # <name>_threads<N> and <name>_threads<N>_cc. The generated classes keep
+    # the same names, so a binary links at most one variant of a model.
+    # Verilator does not support --savable together with --threads, so the
+    # threaded variants are built without it and cannot checkpoint.
+    threaded_vopts = [o for o in vopts if o != "--savable"]
+    for n in threads:
+        for systemc in [True, False]:
+            verilator_cc_library(
+                name = "{}_threads{}{}".format(name, n, "" if systemc else "_cc"),
+                module = ":{}_verilog".format(name),
+                module_top = module_name,
+                visibility = ["//visibility:public"],
+                vopts = threaded_vopts + [
+                    "--pins-bv",
+                    "2",
+                    "--threads",
+                    str(n),
+                ],
+                systemc = systemc,
+            )
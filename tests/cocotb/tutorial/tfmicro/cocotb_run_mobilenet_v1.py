@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import time
+
 import cocotb
 import numpy as np
 
@@ -26,11 +28,17 @@ async def core_mini_rvv_mobilenet_v1(dut):
     r = runfiles.Create()
     elf_files = ['run_mobilenet_v1_025_partial_binary.elf']
     for elf_file in elf_files:
+        start = time.perf_counter()
         await fixture.load_elf_and_lookup_symbols(
             r.Rlocation('coralnpu_hw/tests/cocotb/tutorial/tfmicro/' + elf_file),
             ['inference_status', 'inference_status_message'])
+        loaded = time.perf_counter()
         # NOTE: Running the example in DEBUG mode is too slow could take more than 500Million cycles
         cycle_count = await fixture.run_to_halt(timeout_cycles=130_000_000)
+        finished = time.perf_counter()
+        # Compare with //hw_sim:python_mobilenet_benchmark.
+        print(f"load: {loaded - start:.3f} s, run: {finished - loaded:.3f} s",
+              flush=True)
         print(f"Total number of execution cycles: {cycle_count} \n", flush=True)
         tflite_inference_status = (await fixture.read_word('inference_status')).view(np.int32)
         tflite_inference_message = bytes((await fixture.read('inference_status_message', 31))).decode()
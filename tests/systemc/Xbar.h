@@ -17,27 +17,69 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 #include <systemc>
 #include <tlm>
 #include <tlm_utils/simple_target_socket.h>
 
+#include "tests/systemc/memory_timing.h"
+#include "tests/systemc/sparse_memory.h"
+
 // "Crossbar" containing a memory and a UART.
 class Xbar : sc_core::sc_module {
  public:
-  Xbar(sc_core::sc_module_name name) : sc_core::sc_module(std::move(name)) {
-    memset(memory_, 0xa5, kMemorySizeBytes);
+  static constexpr uint32_t kMemoryAddr = 0x20000000;
+  static constexpr uint32_t kUartAddr = 0x54000000;
+  static constexpr uint64_t kDefaultMemorySizeBytes = 0x400000;
+  // The memory must end below the UART, which b_transport decodes after it.
+  static constexpr uint64_t kMaxMemorySizeBytes = kUartAddr - kMemoryAddr;
+
+  Xbar(sc_core::sc_module_name name)
+      : sc_core::sc_module(std::move(name)),
+        memory_(kDefaultMemorySizeBytes, 0xa5) {
     socket_.register_b_transport(this, &Xbar::b_transport);
   }
 
   tlm_utils::simple_target_socket<Xbar>& socket() { return socket_; }
 
+  // Backing store of the memory region at kMemoryAddr. It may be resized
+  // or have files mapped into it before the simulation starts.
+  SparseMemory& memory() { return memory_; }
+  static constexpr uint32_t memory_addr() { return kMemoryAddr; }
+  uint64_t memory_size() const { return memory_.size(); }
+
+  // Times memory accesses in cycles of `clock_period`, which should be the
+  // period of the clock driving the AXI bridge.
+  void set_memory_timing(const MemoryTiming& timing,
+                         const sc_core::sc_time& clock_period) {
+    timing_.Configure(timing);
+    clock_period_ = clock_period;
+  }
+  const MemoryStats& memory_stats() const { return timing_.stats(); }
+
+  // Saves the memory contents and the timing state (open rows, data path
+  // occupancy and statistics) for a checkpoint.
+  template <typename Stream>
+  void Save(Stream& os) const {
+    memory_.Save(os);
+    timing_.Save(os, cycle_());
+  }
+
+  // Returns false if the checkpoint's memory does not fit the Xbar or its
+  // timing state does not match set_memory_timing().
+  template <typename Stream>
+  bool Restore(Stream& is) {
+    return memory_.Restore(is, kMaxMemorySizeBytes) &&
+           timing_.Restore(is, cycle_());
+  }
+
   void b_transport(tlm::tlm_generic_payload& trans, sc_core::sc_time& delay) {
     sc_dt::uint64 addr = trans.get_address();
     unsigned int len = trans.get_data_length();
 
-    if (((addr & kMemoryAddr) == kMemoryAddr) &&
-        (addr + len < kMemoryAddr + kMemorySizeBytes)) {
+    if (addr >= kMemoryAddr && memory_.Contains(addr - kMemoryAddr, len)) {
+      memory_timing_(addr - kMemoryAddr, len, trans.is_write());
       memory_b_transport_(trans, delay);
     } else if (addr == kUartAddr) {
       uart_b_transport_(trans, delay);
@@ -48,8 +90,30 @@ class Xbar : sc_core::sc_module {
   }
 
  private:
+  // Waits out the access's latency, any stall and its transfer time. The
+  // bridge calls b_transport from a thread, so this can wait() directly.
+  void memory_timing_(uint64_t offset, unsigned int len, bool write) {
+    const uint64_t request = cycle_();
+    const MemoryTiming& timing = timing_.timing();
+    while (timing.max_outstanding && outstanding_ >= timing.max_outstanding) {
+      sc_core::wait(slot_freed_);
+    }
+    outstanding_++;
+    const uint64_t issue = cycle_();
+    const uint64_t done = timing_.Access(request, issue, offset, len, write);
+    if (done > issue) {
+      sc_core::wait(static_cast<double>(done - issue) * clock_period_);
+    }
+    outstanding_--;
+    slot_freed_.notify();
+  }
+
+  uint64_t cycle_() const {
+    return static_cast<uint64_t>(sc_core::sc_time_stamp() / clock_period_);
+  }
+
   void memory_b_transport_(tlm::tlm_generic_payload& trans, sc_core::sc_time& delay) {
-    sc_dt::uint64 addr = trans.get_address() & ~kMemoryAddr;
+    sc_dt::uint64 addr = trans.get_address() - kMemoryAddr;
     unsigned char* ptr = trans.get_data_ptr();
     unsigned int len = trans.get_data_length();
     unsigned int streaming_width = trans.get_streaming_width();
@@ -65,30 +129,30 @@ class Xbar : sc_core::sc_module {
           do_access = be[pos % be_len] == TLM_BYTE_ENABLED;
         }
         if (do_access) {
-          if ((addr + (pos % streaming_width)) >= sc_dt::uint64(kMemorySizeBytes)) {
+          if (!memory_.Contains(addr + (pos % streaming_width), 1)) {
             trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
             SC_REPORT_FATAL("Memory", "Bad address\n");
             return;
           }
 
           if (trans.is_read()) {
-            ptr[pos] = memory_[addr + pos];
+            memory_.Read(addr + pos, ptr + pos, 1);
           } else {
-            memory_[addr + pos] = ptr[pos];
+            memory_.Write(addr + pos, ptr + pos, 1);
           }
         }
       }
     } else {
-      if ((addr + len) > sc_dt::uint64(kMemorySizeBytes)) {
+      if (!memory_.Contains(addr, len)) {
         trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
         SC_REPORT_FATAL("Memory", "Bad address\n");
         return;
       }
 
       if (trans.is_read()) {
-        memcpy(ptr, memory_ + addr, len);
+        memory_.Read(addr, ptr, len);
       } else if (trans.is_write()) {
-        memcpy(memory_ + addr, ptr, len);
+        memory_.Write(addr, ptr, len);
       } else {
         trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
         SC_REPORT_FATAL("Memory", "Bad command\n");
@@ -143,10 +207,11 @@ class Xbar : sc_core::sc_module {
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
   }
 
-  static constexpr uint32_t kMemoryAddr = 0x20000000;
-  static constexpr size_t kMemorySizeBytes = 0x400000;
-  static constexpr uint32_t kUartAddr = 0x54000000;
-  uint8_t memory_[kMemorySizeBytes];
+  SparseMemory memory_;
+  MemoryTimingModel timing_;
+  sc_core::sc_time clock_period_ = sc_core::sc_time(1, sc_core::SC_NS);
+  uint32_t outstanding_ = 0;
+  sc_core::sc_event slot_freed_;
   std::vector<char> uart_buffer_;
   tlm_utils::simple_target_socket<Xbar> socket_;
 };
@@ -16,6 +16,8 @@
 
 #include <cassert>
 #include <cstdio>
+#include <memory>
+#include <string>
 #include <vector>
 
 constexpr uint32_t kEcallInst = 0x00000073;
@@ -104,7 +106,7 @@ void InstructionTrace::TraceInstruction(
     if (!in.completed) {
       break;
     } else {
-      committed_insts_.push_back(in);
+      Commit(in);
       retirement_buffer_.pop_front();
     }
   }
@@ -116,16 +118,41 @@ void InstructionTrace::TraceInstructionRaw(uint32_t pc, uint32_t inst,
                                            const bool trap) {
   Instruction in(pc, inst, reg, trap);
   in.data = data;
-  committed_insts_.push_back(in);
+  Commit(in);
 }
 
-void InstructionTrace::PrintTrace() const {
+bool InstructionTrace::StreamTo(const std::string& path, bool compress) {
+  auto writer = std::make_unique<InstructionTraceWriter>();
+  if (!writer->Open(path, compress)) {
+    return false;
+  }
+  writer_ = std::move(writer);
+  return true;
+}
+
+void InstructionTrace::Commit(const Instruction& in) {
+  if (writer_) {
+    writer_->Append(MakeInstructionTraceRecord(
+        in.pc, in.inst, in.reg, in.data.data(), in.data.size(), in.trap));
+  } else {
+    committed_insts_.push_back(in);
+  }
+}
+
+void InstructionTrace::Reset() {
+  committed_insts_.clear();
+  retirement_buffer_.clear();
+}
+
+void InstructionTrace::PrintTrace() {
+  if (writer_) {
+    writer_->Flush();
+    return;
+  }
   printf("PC,INST,REG,DATA\n");
   for (auto& inst : committed_insts_) {
-    printf("0x%08x,0x%08x,0x%02x,0x", inst.pc, inst.inst, inst.reg);
-    for (auto d : inst.data) {
-      printf("%02x", d);
-    }
-    printf(",trap=%s\n", inst.trap ? "yes" : "no");
+    WriteInstructionTraceCsvRow(stdout, inst.pc, inst.inst, inst.reg,
+                                inst.data.data(), inst.data.size(),
+                                inst.trap);
   }
 }
@@ -17,8 +17,12 @@
 
 #include <cstdint>
 #include <deque>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "tests/systemc/instruction_trace_file.h"
+
 class InstructionTrace {
  public:
   void TraceInstruction(
@@ -35,7 +39,14 @@ class InstructionTrace {
     const std::vector<int>& executeRegBases);
   void TraceInstructionRaw(uint32_t pc, uint32_t inst, uint32_t reg,
                            const std::vector<uint8_t>& data, const bool trap);
-  void PrintTrace() const;
+  // Streams committed instructions to a binary trace at `path` (see
+  // instruction_trace_file.h) instead of keeping them for PrintTrace().
+  bool StreamTo(const std::string& path, bool compress);
+  // Prints the trace as CSV or, when streaming, flushes it to the file.
+  void PrintTrace();
+  // Drops the instructions kept for PrintTrace() and any still waiting to
+  // retire, e.g. before another program runs. A stream stays open.
+  void Reset();
 
   static const int kScalarBaseReg = 0;
   static const int kFloatBaseReg = 32;
@@ -62,7 +73,10 @@ class InstructionTrace {
     bool trap;
     bool completed;
   };
+  void Commit(const Instruction& in);
+
   std::vector<Instruction> committed_insts_;
+  std::unique_ptr<InstructionTraceWriter> writer_;
   std::deque<Instruction> retirement_buffer_;
 };
 
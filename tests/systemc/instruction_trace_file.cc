@@ -0,0 +1,299 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/systemc/instruction_trace_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kRecordBytes = sizeof(InstructionTraceRecord);
+// A token byte with the top bit set stands for (low bits + 1) zero bytes;
+// otherwise (token + 1) literal bytes follow it.
+constexpr uint8_t kZeroRun = 0x80;
+constexpr size_t kMaxRun = 128;
+
+struct BlockHeader {
+  uint32_t records;
+  uint32_t payload_bytes;
+};
+
+}  // namespace
+
+InstructionTraceRecord MakeInstructionTraceRecord(uint32_t pc, uint32_t inst,
+                                                  uint32_t reg,
+                                                  const uint8_t* data,
+                                                  size_t data_bytes,
+                                                  bool trap) {
+  InstructionTraceRecord record;
+  memset(&record, 0, sizeof(record));
+  record.pc = pc;
+  record.inst = inst;
+  record.reg = reg;
+  record.trap = trap;
+  record.data_bytes = std::min<size_t>(data_bytes,
+                                       kInstructionTraceMaxDataBytes);
+  memcpy(record.data, data, record.data_bytes);
+  return record;
+}
+
+void WriteInstructionTraceCsvRow(FILE* f, uint32_t pc, uint32_t inst,
+                                 uint32_t reg, const uint8_t* data,
+                                 size_t data_bytes, bool trap) {
+  fprintf(f, "0x%08x,0x%08x,0x%02x,0x", pc, inst, reg);
+  for (size_t i = 0; i < data_bytes; ++i) {
+    fprintf(f, "%02x", data[i]);
+  }
+  fprintf(f, ",trap=%s\n", trap ? "yes" : "no");
+}
+
+void EncodeInstructionTraceBlock(const InstructionTraceRecord* records,
+                                 size_t count, std::vector<uint8_t>* out) {
+  std::vector<uint8_t> delta(count * kRecordBytes);
+  const uint8_t* raw = reinterpret_cast<const uint8_t*>(records);
+  for (size_t i = 0; i < delta.size(); ++i) {
+    delta[i] = i < kRecordBytes ? raw[i] : raw[i] ^ raw[i - kRecordBytes];
+  }
+
+  out->clear();
+  size_t i = 0;
+  while (i < delta.size()) {
+    size_t zeros = 0;
+    while (i + zeros < delta.size() && delta[i + zeros] == 0 &&
+           zeros < kMaxRun) {
+      zeros++;
+    }
+    if (zeros >= 2) {
+      out->push_back(kZeroRun | (zeros - 1));
+      i += zeros;
+      continue;
+    }
+    // Literals run until the next pair of zeros.
+    size_t literals = 0;
+    while (i + literals < delta.size() && literals < kMaxRun &&
+           !(delta[i + literals] == 0 && i + literals + 1 < delta.size() &&
+             delta[i + literals + 1] == 0)) {
+      literals++;
+    }
+    out->push_back(literals - 1);
+    out->insert(out->end(), delta.begin() + i, delta.begin() + i + literals);
+    i += literals;
+  }
+}
+
+bool DecodeInstructionTraceBlock(const uint8_t* payload, size_t bytes,
+                                 size_t count, InstructionTraceRecord* out) {
+  uint8_t* raw = reinterpret_cast<uint8_t*>(out);
+  const size_t size = count * kRecordBytes;
+  size_t pos = 0;
+  size_t in = 0;
+  while (in < bytes) {
+    const uint8_t token = payload[in++];
+    const size_t run = (token & ~kZeroRun) + 1;
+    if (pos + run > size) return false;
+    if (token & kZeroRun) {
+      memset(raw + pos, 0, run);
+    } else {
+      if (in + run > bytes) return false;
+      memcpy(raw + pos, payload + in, run);
+      in += run;
+    }
+    pos += run;
+  }
+  if (pos != size) return false;
+  for (size_t i = kRecordBytes; i < size; ++i) {
+    raw[i] ^= raw[i - kRecordBytes];
+  }
+  return true;
+}
+
+bool InstructionTraceWriter::Open(const std::string& path, bool compress) {
+  Close();
+  file_ = fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    return false;
+  }
+  compress_ = compress;
+  InstructionTraceHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kInstructionTraceMagic, sizeof(header.magic));
+  header.version = kInstructionTraceVersion;
+  header.record_bytes = kRecordBytes;
+  header.flags = compress ? kInstructionTraceCompressed : 0;
+  if (fwrite(&header, sizeof(header), 1, file_) != 1) {
+    fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+  block_.reserve(kBlockRecords);
+  pending_.reserve(kBlockRecords);
+  stop_ = false;
+  pending_full_ = false;
+  write_failed_ = false;
+  last_submit_ = std::chrono::steady_clock::now();
+  thread_ = std::thread(&InstructionTraceWriter::WriterLoop, this);
+  return true;
+}
+
+void InstructionTraceWriter::Append(const InstructionTraceRecord& record) {
+  if (file_ == nullptr) {
+    return;
+  }
+  block_.push_back(record);
+  if (block_.size() == kBlockRecords ||
+      std::chrono::steady_clock::now() - last_submit_ >= flush_period_) {
+    Submit();
+  }
+}
+
+void InstructionTraceWriter::Flush() {
+  if (file_ == nullptr) {
+    return;
+  }
+  if (!block_.empty()) {
+    Submit();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return !pending_full_; });
+}
+
+void InstructionTraceWriter::Close() {
+  if (file_ == nullptr) {
+    return;
+  }
+  Flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void InstructionTraceWriter::Submit() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return !pending_full_; });
+  pending_.swap(block_);
+  block_.clear();
+  pending_full_ = true;
+  last_submit_ = std::chrono::steady_clock::now();
+  lock.unlock();
+  cv_.notify_all();
+}
+
+void InstructionTraceWriter::WriterLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return pending_full_ || stop_; });
+    if (!pending_full_) {
+      return;
+    }
+    lock.unlock();
+    WriteBlock(pending_);
+    lock.lock();
+    pending_full_ = false;
+    cv_.notify_all();
+  }
+}
+
+void InstructionTraceWriter::WriteBlock(
+    const std::vector<InstructionTraceRecord>& block) {
+  BlockHeader header;
+  header.records = block.size();
+  const void* payload = block.data();
+  header.payload_bytes = block.size() * kRecordBytes;
+  if (compress_) {
+    EncodeInstructionTraceBlock(block.data(), block.size(), &encoded_);
+    payload = encoded_.data();
+    header.payload_bytes = encoded_.size();
+  }
+  // Hand each block to the OS as it is written, so a crash keeps it.
+  const bool written =
+      fwrite(&header, sizeof(header), 1, file_) == 1 &&
+      fwrite(payload, 1, header.payload_bytes, file_) ==
+          header.payload_bytes &&
+      fflush(file_) == 0;
+  if (!written && !write_failed_.exchange(true)) {
+    fprintf(stderr, "Failed to write the instruction trace: %s\n",
+            strerror(errno));
+  }
+}
+
+InstructionTraceReader::~InstructionTraceReader() {
+  if (file_ != nullptr) {
+    fclose(file_);
+  }
+}
+
+bool InstructionTraceReader::Open(const std::string& path) {
+  file_ = fopen(path.c_str(), "rb");
+  if (file_ == nullptr) {
+    return false;
+  }
+  InstructionTraceHeader header;
+  if (fread(&header, sizeof(header), 1, file_) != 1 ||
+      memcmp(header.magic, kInstructionTraceMagic, sizeof(header.magic)) ||
+      header.version != kInstructionTraceVersion ||
+      header.record_bytes != kRecordBytes) {
+    return false;
+  }
+  compressed_ = header.flags & kInstructionTraceCompressed;
+  return true;
+}
+
+bool InstructionTraceReader::Next(InstructionTraceRecord* record) {
+  while (next_ == block_.size()) {
+    if (!ReadBlock()) {
+      return false;
+    }
+  }
+  *record = block_[next_++];
+  return true;
+}
+
+bool InstructionTraceReader::ReadBlock() {
+  BlockHeader header;
+  const size_t got = fread(&header, 1, sizeof(header), file_);
+  if (got != sizeof(header)) {
+    truncated_ = got != 0;
+    return false;
+  }
+  const size_t raw_bytes = size_t(header.records) * kRecordBytes;
+  if (header.records > InstructionTraceWriter::kBlockRecords ||
+      (!compressed_ && header.payload_bytes != raw_bytes)) {
+    truncated_ = true;
+    return false;
+  }
+  payload_.resize(header.payload_bytes);
+  block_.resize(header.records);
+  next_ = 0;
+  if (fread(payload_.data(), 1, payload_.size(), file_) != payload_.size()) {
+    block_.clear();
+    truncated_ = true;
+    return false;
+  }
+  if (!compressed_) {
+    memcpy(block_.data(), payload_.data(), raw_bytes);
+  } else if (!DecodeInstructionTraceBlock(payload_.data(), payload_.size(),
+                                          block_.size(), block_.data())) {
+    block_.clear();
+    truncated_ = true;
+    return false;
+  }
+  return true;
+}
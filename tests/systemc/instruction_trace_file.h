@@ -0,0 +1,153 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_SYSTEMC_INSTRUCTION_TRACE_FILE_H_
+#define TESTS_SYSTEMC_INSTRUCTION_TRACE_FILE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Binary instruction trace: an InstructionTraceHeader followed by blocks of
+// fixed-size InstructionTraceRecords. Each block is a uint32 record count and
+// a uint32 payload size, then the payload. Compressed payloads XOR each
+// record with the one before it in the block and run-length encode the
+// zeros, which removes most of the repeated PCs, instructions and padding.
+// Blocks are independent, so a trace cut short by a crash reads up to its
+// last whole block. All fields are host (little) endian.
+
+constexpr int kInstructionTraceMaxDataBytes = 32;  // Up to VLEN 256.
+
+struct InstructionTraceRecord {
+  uint32_t pc;
+  uint32_t inst;
+  uint32_t reg;
+  uint8_t data_bytes;
+  uint8_t trap;
+  uint8_t reserved[2];
+  uint8_t data[kInstructionTraceMaxDataBytes];
+};
+static_assert(sizeof(InstructionTraceRecord) == 48,
+              "InstructionTraceRecord is a file format");
+
+struct InstructionTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_bytes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+constexpr char kInstructionTraceMagic[8] = {'C', 'N', 'P', 'U',
+                                            'I', 'T', 'R', 'C'};
+constexpr uint32_t kInstructionTraceVersion = 1;
+constexpr uint32_t kInstructionTraceCompressed = 1 << 0;
+
+// Fills a record, keeping at most kInstructionTraceMaxDataBytes of `data`.
+InstructionTraceRecord MakeInstructionTraceRecord(uint32_t pc, uint32_t inst,
+                                                  uint32_t reg,
+                                                  const uint8_t* data,
+                                                  size_t data_bytes,
+                                                  bool trap);
+
+// Writes the CSV row PrintTrace() and instruction_trace_to_csv emit, below
+// the "PC,INST,REG,DATA" header.
+void WriteInstructionTraceCsvRow(FILE* f, uint32_t pc, uint32_t inst,
+                                 uint32_t reg, const uint8_t* data,
+                                 size_t data_bytes, bool trap);
+
+// Appends records from the simulation thread and writes them from a
+// background thread, one block at a time. At most one block waits for the
+// writer, so memory stays bounded however long the run; Append() blocks if
+// the disk falls behind. A block is also handed over before it is full once
+// the flush period has passed, so a run that crashes or is killed keeps all
+// but its last moments.
+class InstructionTraceWriter {
+ public:
+  static constexpr size_t kBlockRecords = 4096;
+  static constexpr std::chrono::milliseconds kDefaultFlushPeriod{1000};
+
+  InstructionTraceWriter() = default;
+  InstructionTraceWriter(const InstructionTraceWriter&) = delete;
+  InstructionTraceWriter& operator=(const InstructionTraceWriter&) = delete;
+  ~InstructionTraceWriter() { Close(); }
+
+  bool Open(const std::string& path, bool compress);
+  void Append(const InstructionTraceRecord& record);
+  // Returns once everything appended so far is written to the file.
+  void Flush();
+  void Close();
+  void set_flush_period(std::chrono::milliseconds period) {
+    flush_period_ = period;
+  }
+  // True once a block could not be written; the first failure is logged.
+  bool write_failed() const { return write_failed_; }
+
+ private:
+  void Submit();
+  void WriterLoop();
+  void WriteBlock(const std::vector<InstructionTraceRecord>& block);
+
+  FILE* file_ = nullptr;
+  bool compress_ = false;
+  std::vector<InstructionTraceRecord> block_;
+  std::vector<InstructionTraceRecord> pending_;
+  std::vector<uint8_t> encoded_;
+  bool pending_full_ = false;
+  bool stop_ = false;
+  std::chrono::milliseconds flush_period_ = kDefaultFlushPeriod;
+  std::chrono::steady_clock::time_point last_submit_;
+  std::atomic<bool> write_failed_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+};
+
+class InstructionTraceReader {
+ public:
+  InstructionTraceReader() = default;
+  InstructionTraceReader(const InstructionTraceReader&) = delete;
+  InstructionTraceReader& operator=(const InstructionTraceReader&) = delete;
+  ~InstructionTraceReader();
+
+  bool Open(const std::string& path);
+  // Returns false at the end of the trace, or at the first malformed or
+  // partial block (see truncated()).
+  bool Next(InstructionTraceRecord* record);
+  bool truncated() const { return truncated_; }
+
+ private:
+  bool ReadBlock();
+
+  FILE* file_ = nullptr;
+  bool compressed_ = false;
+  bool truncated_ = false;
+  std::vector<InstructionTraceRecord> block_;
+  size_t next_ = 0;
+  std::vector<uint8_t> payload_;
+};
+
+// Block payload codecs, exposed for tests.
+void EncodeInstructionTraceBlock(const InstructionTraceRecord* records,
+                                 size_t count, std::vector<uint8_t>* out);
+bool DecodeInstructionTraceBlock(const uint8_t* payload, size_t bytes,
+                                 size_t count, InstructionTraceRecord* out);
+
+#endif  // TESTS_SYSTEMC_INSTRUCTION_TRACE_FILE_H_
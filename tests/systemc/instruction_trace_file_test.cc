@@ -0,0 +1,156 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Round-trips instruction traces through the writer and reader, compressed
+// and not, including a trace cut off mid-block, and checks that partial
+// blocks reach the file on the flush period and that write errors surface.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tests/systemc/instruction_trace_file.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+// A loop-like program: PCs step by 4 and wrap, with mostly small data.
+std::vector<InstructionTraceRecord> MakeRecords(size_t count) {
+  std::vector<InstructionTraceRecord> records;
+  srand(1);
+  for (size_t i = 0; i < count; ++i) {
+    uint8_t data[kInstructionTraceMaxDataBytes] = {0};
+    const size_t bytes = i % 7 == 0 ? 16 : 4;
+    for (size_t b = 0; b < bytes; b += 4) {
+      data[b + 3] = ::rand() & 0xff;
+    }
+    records.push_back(MakeInstructionTraceRecord(
+        0x1000 + 4 * (i % 64), 0x00a50513 + (i % 64), (i % 31) + 1, data,
+        bytes, i % 1000 == 999));
+  }
+  return records;
+}
+
+bool SameRecord(const InstructionTraceRecord& a,
+                const InstructionTraceRecord& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+bool RoundTrip(const std::vector<InstructionTraceRecord>& records,
+               bool compress, off_t* file_bytes) {
+  char path[] = "/tmp/instruction_trace_testXXXXXX";
+  close(mkstemp(path));
+  {
+    InstructionTraceWriter writer;
+    if (!writer.Open(path, compress)) return false;
+    for (const auto& record : records) writer.Append(record);
+  }
+  struct stat sb;
+  stat(path, &sb);
+  *file_bytes = sb.st_size;
+
+  InstructionTraceReader reader;
+  bool ok = reader.Open(path);
+  InstructionTraceRecord record;
+  size_t n = 0;
+  while (ok && reader.Next(&record)) {
+    ok = n < records.size() && SameRecord(record, records[n]);
+    n++;
+  }
+  unlink(path);
+  return ok && n == records.size() && !reader.truncated();
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+  const auto records =
+      MakeRecords(3 * InstructionTraceWriter::kBlockRecords + 123);
+
+  off_t raw_bytes = 0;
+  off_t compressed_bytes = 0;
+  ok &= Check(RoundTrip(records, false, &raw_bytes), "raw round trip");
+  ok &= Check(RoundTrip(records, true, &compressed_bytes),
+              "compressed round trip");
+  ok &= Check(compressed_bytes * 2 < raw_bytes, "compression ratio");
+
+  // Data beyond the record's capacity is dropped, not overrun.
+  std::vector<uint8_t> wide(64, 0xff);
+  auto record = MakeInstructionTraceRecord(0, 0, 0, wide.data(), wide.size(),
+                                           false);
+  ok &= Check(record.data_bytes == kInstructionTraceMaxDataBytes, "clamp");
+
+  // A file cut in the middle of its second block reads the first block.
+  char path[] = "/tmp/instruction_trace_testXXXXXX";
+  close(mkstemp(path));
+  {
+    InstructionTraceWriter writer;
+    ok &= Check(writer.Open(path, true), "open");
+    // Full blocks only, whatever the machine's speed.
+    writer.set_flush_period(std::chrono::hours(1));
+    for (size_t i = 0; i < 2 * InstructionTraceWriter::kBlockRecords; ++i) {
+      writer.Append(records[i]);
+    }
+  }
+  struct stat sb;
+  stat(path, &sb);
+  ok &= Check(truncate(path, sb.st_size - 10) == 0, "truncate");
+  InstructionTraceReader reader;
+  ok &= Check(reader.Open(path), "open truncated");
+  size_t n = 0;
+  InstructionTraceRecord read;
+  while (reader.Next(&read)) n++;
+  ok &= Check(n == InstructionTraceWriter::kBlockRecords, "partial trace");
+  ok &= Check(reader.truncated(), "reports truncation");
+  unlink(path);
+
+  // With a zero flush period every record is handed over as it comes, and
+  // Append() waits for the previous one to be written, so all but the last
+  // are readable while the writer is still open.
+  close(mkstemp(path));
+  {
+    InstructionTraceWriter writer;
+    ok &= Check(writer.Open(path, false), "open flushing");
+    writer.set_flush_period(std::chrono::milliseconds(0));
+    for (size_t i = 0; i < 3; ++i) {
+      writer.Append(records[i]);
+    }
+    InstructionTraceReader partial;
+    ok &= Check(partial.Open(path), "open while writing");
+    n = 0;
+    while (partial.Next(&read) && SameRecord(read, records[n])) n++;
+    ok &= Check(n >= 2, "partial blocks flushed");
+    ok &= Check(!writer.write_failed(), "no write error");
+  }
+  unlink(path);
+
+  // A full disk fails the block write rather than going unnoticed.
+  {
+    InstructionTraceWriter writer;
+    if (writer.Open("/dev/full", false)) {
+      writer.Append(records[0]);
+      writer.Flush();
+      ok &= Check(writer.write_failed(), "write error reported");
+    }
+  }
+
+  return TestResult(ok);
+}
@@ -0,0 +1,60 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Converts a binary instruction trace (e.g. from core_mini_axi_sim
+// --instr_trace_file) to the CSV that --instr_trace prints.
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "tests/systemc/instruction_trace_file.h"
+
+ABSL_FLAG(std::string, input, "", "Binary instruction trace to read");
+ABSL_FLAG(std::string, output, "", "CSV file to write; stdout if empty");
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const std::string input = absl::GetFlag(FLAGS_input);
+  const std::string output = absl::GetFlag(FLAGS_output);
+
+  InstructionTraceReader reader;
+  if (!reader.Open(input)) {
+    std::cout << "Failed to read an instruction trace from " << input
+              << std::endl;
+    return 1;
+  }
+  FILE* f = output.empty() ? stdout : fopen(output.c_str(), "w");
+  if (f == nullptr) {
+    std::cout << "Failed to open " << output << std::endl;
+    return 1;
+  }
+
+  fprintf(f, "PC,INST,REG,DATA\n");
+  InstructionTraceRecord record;
+  while (reader.Next(&record)) {
+    WriteInstructionTraceCsvRow(f, record.pc, record.inst, record.reg,
+                                record.data, record.data_bytes, record.trap);
+  }
+  if (f != stdout) {
+    fclose(f);
+  }
+  if (reader.truncated()) {
+    std::cerr << input << " ends with a partial block" << std::endl;
+    return 2;
+  }
+  return 0;
+}
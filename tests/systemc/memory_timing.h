@@ -0,0 +1,165 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_SYSTEMC_MEMORY_TIMING_H_
+#define TESTS_SYSTEMC_MEMORY_TIMING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Timing of the external memory, in cycles of the clock it is attached to.
+// The defaults complete every access instantly.
+struct MemoryTiming {
+  // Cycles from a request to its first byte when the row is open (or when
+  // there is no row model).
+  uint32_t latency_cycles = 0;
+  // Extra cycles when the access has to open a new row.
+  uint32_t row_miss_cycles = 0;
+  // Bytes per row, with consecutive rows interleaved across `banks` that
+  // each keep one row open; 0 disables the row-buffer model.
+  uint32_t row_bytes = 0;
+  uint32_t banks = 1;
+  // Data bytes moved per cycle on the shared data path; 0 is unlimited.
+  uint32_t bytes_per_cycle = 0;
+  // Requests in flight at once; later requests stall. 0 is unlimited.
+  uint32_t max_outstanding = 0;
+};
+
+struct MemoryStats {
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+  uint64_t row_hits = 0;
+  uint64_t row_misses = 0;
+  // Cycles requests spent waiting for an outstanding slot or the data path,
+  // on top of their latency and transfer time.
+  uint64_t stall_cycles = 0;
+  // Cycles between the first request and the last completion.
+  uint64_t active_cycles = 0;
+
+  double bytes_per_cycle() const {
+    return active_cycles ? double(read_bytes + write_bytes) / active_cycles
+                         : 0.0;
+  }
+};
+
+// Open rows, data path occupancy and statistics of MemoryTiming, in whole
+// cycles. The caller owns the clock and the outstanding-request limit; Xbar
+// drives this from b_transport.
+class MemoryTimingModel {
+ public:
+  void Configure(const MemoryTiming& timing) {
+    timing_ = timing;
+    open_rows_.assign(std::max(timing.banks, 1u), -1);
+  }
+  const MemoryTiming& timing() const { return timing_; }
+  const MemoryStats& stats() const { return stats_; }
+
+  // Accounts for an access of `len` bytes at `offset` that was requested in
+  // cycle `request` and got an outstanding slot in cycle `issue`. Returns
+  // the cycle in which its last byte has moved.
+  uint64_t Access(uint64_t request, uint64_t issue, uint64_t offset,
+                  uint32_t len, bool write) {
+    if (stats_.reads + stats_.writes == 0) {
+      first_request_ = static_cast<int64_t>(request);
+    }
+    if (write) {
+      stats_.writes++;
+      stats_.write_bytes += len;
+    } else {
+      stats_.reads++;
+      stats_.read_bytes += len;
+    }
+
+    uint64_t latency = timing_.latency_cycles;
+    if (timing_.row_bytes) {
+      const uint64_t row = offset / timing_.row_bytes;
+      int64_t& open_row = open_rows_[row % open_rows_.size()];
+      if (open_row == int64_t(row)) {
+        stats_.row_hits++;
+      } else {
+        stats_.row_misses++;
+        latency += timing_.row_miss_cycles;
+        open_row = row;
+      }
+    }
+    const uint64_t ready = issue + latency;
+    const uint64_t start = std::max(ready, data_path_free_);
+    uint64_t transfer = 0;
+    if (timing_.bytes_per_cycle) {
+      transfer =
+          (len + timing_.bytes_per_cycle - 1) / timing_.bytes_per_cycle;
+    }
+    data_path_free_ = start + transfer;
+
+    stats_.stall_cycles += (issue - request) + (start - ready);
+    stats_.active_cycles =
+        std::max(stats_.active_cycles,
+                 static_cast<uint64_t>(int64_t(data_path_free_) -
+                                       first_request_));
+    return data_path_free_;
+  }
+
+  // Checkpoint support, for VerilatedSave/VerilatedRestore or any stream
+  // with write(const void*, size_t) / read(void*, size_t). Cycles are
+  // stored relative to `now`, so a restored model may run on a clock that
+  // restarted from zero. The MemoryTiming itself comes from Configure().
+  template <typename Stream>
+  void Save(Stream& os, uint64_t now) const {
+    os.write(&stats_, sizeof(stats_));
+    const uint64_t banks = open_rows_.size();
+    os.write(&banks, sizeof(banks));
+    os.write(open_rows_.data(), banks * sizeof(open_rows_[0]));
+    const uint64_t busy = data_path_free_ > now ? data_path_free_ - now : 0;
+    os.write(&busy, sizeof(busy));
+    const int64_t since_first = int64_t(now) - first_request_;
+    os.write(&since_first, sizeof(since_first));
+  }
+
+  // Returns false, leaving the model as it was, if the checkpoint was saved
+  // with a different number of banks than Configure() set up.
+  template <typename Stream>
+  bool Restore(Stream& is, uint64_t now) {
+    MemoryStats stats;
+    is.read(&stats, sizeof(stats));
+    uint64_t banks;
+    is.read(&banks, sizeof(banks));
+    if (banks != open_rows_.size()) {
+      return false;
+    }
+    stats_ = stats;
+    is.read(open_rows_.data(), banks * sizeof(open_rows_[0]));
+    uint64_t busy;
+    is.read(&busy, sizeof(busy));
+    data_path_free_ = now + busy;
+    int64_t since_first;
+    is.read(&since_first, sizeof(since_first));
+    first_request_ = int64_t(now) - since_first;
+    return true;
+  }
+
+ private:
+  MemoryTiming timing_;
+  MemoryStats stats_;
+  // Row open in each bank, or -1.
+  std::vector<int64_t> open_rows_ = std::vector<int64_t>(1, -1);
+  // Cycle in which the shared data path finishes its last transfer.
+  uint64_t data_path_free_ = 0;
+  // Signed, as a restored model's first request predates its clock.
+  int64_t first_request_ = 0;
+};
+
+#endif  // TESTS_SYSTEMC_MEMORY_TIMING_H_
@@ -0,0 +1,129 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks the external memory's row hits, stalls and active cycles, and that
+// a checkpoint carries them over to a clock that restarted.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "tests/systemc/memory_timing.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+// In-memory stream with the write/read interface of VerilatedSave/Restore.
+struct Buffer {
+  std::vector<uint8_t> bytes;
+  size_t pos = 0;
+  void write(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    bytes.insert(bytes.end(), p, p + size);
+  }
+  void read(void* data, size_t size) {
+    memcpy(data, bytes.data() + pos, size);
+    pos += size;
+  }
+};
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+
+  // The defaults complete every access in the cycle it is issued.
+  MemoryTimingModel instant;
+  instant.Configure(MemoryTiming());
+  ok &= Check(instant.Access(5, 5, 0, 64, false) == 5, "instant access");
+  ok &= Check(instant.stats().reads == 1 && instant.stats().read_bytes == 64,
+              "instant read counted");
+  ok &= Check(instant.stats().stall_cycles == 0 &&
+                  instant.stats().active_cycles == 0,
+              "instant stalls and active cycles");
+
+  // Rows of 1 KiB interleaved over two banks; a miss costs 5 extra cycles.
+  MemoryTiming row_timing;
+  row_timing.latency_cycles = 10;
+  row_timing.row_miss_cycles = 5;
+  row_timing.row_bytes = 1024;
+  row_timing.banks = 2;
+  MemoryTimingModel rows;
+  rows.Configure(row_timing);
+  ok &= Check(rows.Access(0, 0, 0, 4, false) == 15, "first access misses");
+  ok &= Check(rows.Access(20, 20, 100, 4, true) == 30, "same row hits");
+  ok &= Check(rows.Access(40, 40, 2048, 4, false) == 55, "bank 0 row 2");
+  ok &= Check(rows.Access(60, 60, 1024, 4, false) == 75, "bank 1 row 1");
+  ok &= Check(rows.Access(80, 80, 0, 4, false) == 95, "bank 0 reopens row 0");
+  ok &= Check(rows.stats().row_hits == 1, "row hits");
+  ok &= Check(rows.stats().row_misses == 4, "row misses");
+  ok &= Check(rows.stats().reads == 4 && rows.stats().writes == 1,
+              "row reads and writes");
+  ok &= Check(rows.stats().stall_cycles == 0, "row stalls");
+  ok &= Check(rows.stats().active_cycles == 95, "row active cycles");
+
+  // 4 bytes per cycle behind 2 cycles of latency. The second access waits
+  // for the data path; the third also waited 2 cycles for a slot.
+  MemoryTiming bandwidth_timing;
+  bandwidth_timing.latency_cycles = 2;
+  bandwidth_timing.bytes_per_cycle = 4;
+  MemoryTimingModel bandwidth;
+  bandwidth.Configure(bandwidth_timing);
+  ok &= Check(bandwidth.Access(0, 0, 0, 16, false) == 6, "first transfer");
+  ok &= Check(bandwidth.Access(1, 1, 64, 16, false) == 10,
+              "queued transfer");
+  ok &= Check(bandwidth.Access(2, 4, 128, 16, true) == 14,
+              "slot and data path stall");
+  ok &= Check(bandwidth.stats().stall_cycles == 3 + 2 + 4, "stall cycles");
+  ok &= Check(bandwidth.stats().active_cycles == 14, "active cycles");
+  ok &= Check(bandwidth.stats().bytes_per_cycle() == 48.0 / 14,
+              "bytes per cycle");
+
+  // Saved in cycle 8 with the data path busy until 14, then restored on a
+  // clock at 100: the data path is busy until 106 and the first request
+  // counts as 8 cycles back.
+  Buffer checkpoint;
+  bandwidth.Save(checkpoint, 8);
+  MemoryTimingModel restored;
+  restored.Configure(bandwidth_timing);
+  ok &= Check(restored.Restore(checkpoint, 100), "restore");
+  ok &= Check(restored.stats().stall_cycles == 9 &&
+                  restored.stats().reads == 2 && restored.stats().writes == 1,
+              "restored stats");
+  ok &= Check(restored.Access(100, 100, 192, 16, false) == 110,
+              "restored data path");
+  ok &= Check(restored.stats().stall_cycles == 13, "restored stall cycles");
+  ok &= Check(restored.stats().active_cycles == 18, "restored active cycles");
+
+  // Open rows survive a checkpoint too.
+  Buffer row_checkpoint;
+  rows.Save(row_checkpoint, 95);
+  MemoryTimingModel restored_rows;
+  restored_rows.Configure(row_timing);
+  ok &= Check(restored_rows.Restore(row_checkpoint, 0), "restore rows");
+  ok &= Check(restored_rows.Access(0, 0, 1024 + 8, 4, false) == 10,
+              "restored open row hits");
+  ok &= Check(restored_rows.stats().row_hits == 2, "restored row hits");
+
+  // A checkpoint from a model with another number of banks is rejected.
+  row_checkpoint.pos = 0;
+  MemoryTiming four_banks = row_timing;
+  four_banks.banks = 4;
+  MemoryTimingModel mismatched;
+  mismatched.Configure(four_banks);
+  ok &= Check(!mismatched.Restore(row_checkpoint, 0), "bank mismatch");
+  ok &= Check(mismatched.stats().reads == 0, "bank mismatch keeps stats");
+
+  return TestResult(ok);
+}
@@ -0,0 +1,217 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_SYSTEMC_SPARSE_MEMORY_H_
+#define TESTS_SYSTEMC_SPARSE_MEMORY_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Memory whose pages are allocated on first write; unwritten bytes read as
+// `fill`. Files can be mapped in copy-on-write, so preloaded blobs (e.g.
+// model weights) are only paged in by the host as the simulation reads them.
+class SparseMemory {
+ public:
+  static constexpr uint64_t kPageBytes = 64 * 1024;
+
+  SparseMemory(uint64_t size_bytes, uint8_t fill) : fill_(fill) {
+    Resize(size_bytes);
+  }
+  SparseMemory(const SparseMemory&) = delete;
+  SparseMemory& operator=(const SparseMemory&) = delete;
+
+  ~SparseMemory() { Clear(); }
+
+  uint64_t size() const { return size_bytes_; }
+
+  // Grows or shrinks the memory; pages beyond the new size are dropped.
+  void Resize(uint64_t size_bytes) {
+    size_bytes_ = size_bytes;
+    const uint64_t pages = (size_bytes + kPageBytes - 1) / kPageBytes;
+    pages_.resize(pages, nullptr);
+    owned_pages_.resize(pages);
+  }
+
+  // Drops every page and mapped file, so the whole memory reads as `fill`
+  // again.
+  void Clear() {
+    std::fill(pages_.begin(), pages_.end(), nullptr);
+    for (auto& page : owned_pages_) {
+      page.reset();
+    }
+    for (const auto& mapping : mappings_) {
+      munmap(mapping.first, mapping.second);
+    }
+    mappings_.clear();
+  }
+
+  bool Contains(uint64_t offset, uint64_t len) const {
+    return len <= size_bytes_ && offset <= size_bytes_ - len;
+  }
+
+  void Read(uint64_t offset, uint8_t* dest, uint64_t len) const {
+    while (len > 0) {
+      const uint64_t page_offset = offset % kPageBytes;
+      const uint64_t bytes = std::min(len, kPageBytes - page_offset);
+      const uint8_t* page = pages_[offset / kPageBytes];
+      if (page) {
+        memcpy(dest, page + page_offset, bytes);
+      } else {
+        memset(dest, fill_, bytes);
+      }
+      offset += bytes;
+      dest += bytes;
+      len -= bytes;
+    }
+  }
+
+  void Write(uint64_t offset, const uint8_t* src, uint64_t len) {
+    while (len > 0) {
+      const uint64_t page_offset = offset % kPageBytes;
+      const uint64_t bytes = std::min(len, kPageBytes - page_offset);
+      memcpy(GetPage(offset / kPageBytes) + page_offset, src, bytes);
+      offset += bytes;
+      src += bytes;
+      len -= bytes;
+    }
+  }
+
+  // Maps the file at `path` to `offset`, which must be page aligned. Returns
+  // false if the file cannot be mapped or does not fit.
+  bool MapFile(uint64_t offset, const std::string& path) {
+    if (offset % kPageBytes != 0) {
+      return false;
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || !Contains(offset, sb.st_size)) {
+      close(fd);
+      return false;
+    }
+    const uint64_t file_size = sb.st_size;
+    // Whole pages come straight from the mapping; a partial last page is
+    // copied, since touching a mapping past the end of the file faults.
+    const uint64_t mapped_bytes = file_size - file_size % kPageBytes;
+    uint8_t* data = nullptr;
+    if (mapped_bytes > 0) {
+      void* addr = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        close(fd);
+        return false;
+      }
+      data = static_cast<uint8_t*>(addr);
+      mappings_.emplace_back(addr, mapped_bytes);
+    }
+    for (uint64_t i = 0; i < mapped_bytes / kPageBytes; i++) {
+      const uint64_t page = offset / kPageBytes + i;
+      owned_pages_[page].reset();
+      pages_[page] = data + i * kPageBytes;
+    }
+    if (mapped_bytes != file_size) {
+      std::vector<uint8_t> tail(file_size - mapped_bytes);
+      const bool ok =
+          pread(fd, tail.data(), tail.size(), mapped_bytes) ==
+          static_cast<ssize_t>(tail.size());
+      if (!ok) {
+        close(fd);
+        return false;
+      }
+      Write(offset + mapped_bytes, tail.data(), tail.size());
+    }
+    close(fd);
+    return true;
+  }
+
+  // Number of pages that have been written or mapped.
+  size_t touched_pages() const {
+    return pages_.size() - std::count(pages_.begin(), pages_.end(), nullptr);
+  }
+
+  // Checkpoint support, for VerilatedSave/VerilatedRestore or any stream
+  // with write(const void*, size_t) / read(void*, size_t). Only touched
+  // pages are stored.
+  template <typename Stream>
+  void Save(Stream& os) const {
+    os.write(&size_bytes_, sizeof(size_bytes_));
+    uint64_t count = touched_pages();
+    os.write(&count, sizeof(count));
+    for (uint64_t i = 0; i < pages_.size(); i++) {
+      if (pages_[i]) {
+        os.write(&i, sizeof(i));
+        os.write(pages_[i], kPageBytes);
+      }
+    }
+  }
+
+  // Returns false, leaving the memory empty, if the checkpoint is larger
+  // than `max_size_bytes` or names a page outside its own size.
+  template <typename Stream>
+  bool Restore(Stream& is, uint64_t max_size_bytes) {
+    Clear();
+    uint64_t size_bytes;
+    is.read(&size_bytes, sizeof(size_bytes));
+    if (size_bytes > max_size_bytes) {
+      return false;
+    }
+    Resize(size_bytes);
+    uint64_t count;
+    is.read(&count, sizeof(count));
+    if (count > pages_.size()) {
+      return false;
+    }
+    for (uint64_t n = 0; n < count; n++) {
+      uint64_t i;
+      is.read(&i, sizeof(i));
+      if (i >= pages_.size()) {
+        Clear();
+        return false;
+      }
+      is.read(GetPage(i), kPageBytes);
+    }
+    return true;
+  }
+
+ private:
+  uint8_t* GetPage(uint64_t index) {
+    if (!pages_[index]) {
+      owned_pages_[index] = std::make_unique<uint8_t[]>(kPageBytes);
+      memset(owned_pages_[index].get(), fill_, kPageBytes);
+      pages_[index] = owned_pages_[index].get();
+    }
+    return pages_[index];
+  }
+
+  const uint8_t fill_;
+  uint64_t size_bytes_ = 0;
+  // Flat page table; null pages have never been touched.
+  std::vector<uint8_t*> pages_;
+  std::vector<std::unique_ptr<uint8_t[]>> owned_pages_;
+  std::vector<std::pair<void*, size_t>> mappings_;
+};
+
+#endif  // TESTS_SYSTEMC_SPARSE_MEMORY_H_
@@ -0,0 +1,139 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks SparseMemory's lazy pages, file mappings and checkpoint round trip.
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tests/systemc/sparse_memory.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+// In-memory stream with the write/read interface of VerilatedSave/Restore.
+struct Buffer {
+  std::vector<uint8_t> bytes;
+  size_t pos = 0;
+  void write(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    bytes.insert(bytes.end(), p, p + size);
+  }
+  void read(void* data, size_t size) {
+    memcpy(data, bytes.data() + pos, size);
+    pos += size;
+  }
+};
+
+}  // namespace
+
+int main() {
+  constexpr uint64_t kSize = 256ull << 20;
+  constexpr uint64_t kPage = SparseMemory::kPageBytes;
+  SparseMemory memory(kSize, 0xa5);
+  bool ok = true;
+
+  // Untouched memory reads as the fill value and allocates nothing.
+  std::vector<uint8_t> buffer(64, 0);
+  memory.Read(kSize - 64, buffer.data(), buffer.size());
+  ok &= Check(buffer == std::vector<uint8_t>(64, 0xa5), "fill value");
+  ok &= Check(memory.touched_pages() == 0, "read allocated a page");
+  ok &= Check(memory.Contains(kSize - 64, 64), "contains end");
+  ok &= Check(!memory.Contains(kSize - 63, 64), "past end");
+
+  // A write straddling a page boundary lands in two pages.
+  std::vector<uint8_t> data(64);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i + 1);
+  }
+  memory.Write(kPage - 32, data.data(), data.size());
+  ok &= Check(memory.touched_pages() == 2, "straddling write pages");
+  memory.Read(kPage - 32, buffer.data(), buffer.size());
+  ok &= Check(buffer == data, "straddling readback");
+
+  // A mapped file shows up at its offset; its partial last page is copied
+  // and the rest of that page keeps the fill value.
+  char path[] = "/tmp/sparse_memory_testXXXXXX";
+  int fd = mkstemp(path);
+  std::vector<uint8_t> blob(kPage + 100);
+  for (size_t i = 0; i < blob.size(); i++) {
+    blob[i] = static_cast<uint8_t>(i * 7);
+  }
+  ok &= Check(write(fd, blob.data(), blob.size()) ==
+                  static_cast<ssize_t>(blob.size()),
+              "write blob");
+  close(fd);
+  ok &= Check(!memory.MapFile(kPage + 1, path), "unaligned map");
+  ok &= Check(memory.MapFile(16 * kPage, path), "map file");
+  std::vector<uint8_t> readback(blob.size() + 4);
+  memory.Read(16 * kPage, readback.data(), readback.size());
+  ok &= Check(memcmp(readback.data(), blob.data(), blob.size()) == 0,
+              "mapped contents");
+  ok &= Check(readback[blob.size()] == 0xa5, "mapped tail fill");
+
+  // Writes to a mapping stay in memory, not in the file.
+  memory.Write(16 * kPage, data.data(), 4);
+  FILE* f = fopen(path, "rb");
+  uint8_t first = 0xff;
+  ok &= Check(fread(&first, 1, 1, f) == 1 && first == blob[0],
+              "mapping is copy-on-write");
+  fclose(f);
+  unlink(path);
+
+  // Checkpoints hold touched pages only and restore them exactly.
+  Buffer checkpoint;
+  memory.Save(checkpoint);
+  ok &= Check(checkpoint.bytes.size() < 5 * (kPage + 8) + 16,
+              "checkpoint size");
+  SparseMemory restored(kSize / 2, 0xa5);
+  restored.Write(100 * kPage, data.data(), data.size());
+  ok &= Check(restored.Restore(checkpoint, kSize), "restore");
+  ok &= Check(restored.size() == kSize, "restored size");
+  ok &= Check(restored.touched_pages() == memory.touched_pages(),
+              "restored pages");
+  std::vector<uint8_t> expected(3 * kPage);
+  std::vector<uint8_t> actual(3 * kPage);
+  memory.Read(15 * kPage, expected.data(), expected.size());
+  restored.Read(15 * kPage, actual.data(), actual.size());
+  ok &= Check(expected == actual, "restored contents");
+  restored.Read(100 * kPage, buffer.data(), buffer.size());
+  ok &= Check(buffer == std::vector<uint8_t>(64, 0xa5), "restore clears");
+
+  // A checkpoint larger than allowed, or naming a page past its size, is
+  // rejected and leaves the memory empty.
+  checkpoint.pos = 0;
+  ok &= Check(!restored.Restore(checkpoint, kSize - 1), "oversized restore");
+  ok &= Check(restored.touched_pages() == 0, "oversized restore clears");
+  Buffer corrupt;
+  const uint64_t header[] = {kPage, 1, 1};
+  corrupt.write(header, sizeof(header));
+  corrupt.write(blob.data(), kPage);
+  restored.Write(0, data.data(), data.size());
+  ok &= Check(!restored.Restore(corrupt, kSize), "page past the end");
+  ok &= Check(restored.touched_pages() == 0, "bad page restore clears");
+
+  // Clear drops written and mapped pages alike.
+  restored.Clear();
+  ok &= Check(restored.touched_pages() == 0, "cleared pages");
+  restored.Read(16 * kPage, buffer.data(), buffer.size());
+  ok &= Check(buffer == std::vector<uint8_t>(64, 0xa5), "cleared contents");
+
+  return TestResult(ok);
+}
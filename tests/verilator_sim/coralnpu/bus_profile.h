@@ -0,0 +1,161 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_VERILATOR_SIM_CORALNPU_BUS_PROFILE_H_
+#define TESTS_VERILATOR_SIM_CORALNPU_BUS_PROFILE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr int kAxiWaitState = 3;
+
+// How a bus model drives ready. Every mode but kRandom repeats exactly from
+// run to run, so cycle counts measure the core rather than the stalls.
+struct BusProfile {
+  enum Mode {
+    kRandom,       // rand() & 1, the historical 50% stall rate.
+    kAlwaysReady,  // Ready every cycle.
+    kWaitState,    // Ready after `wait_states` cycles of valid.
+    kSeeded,       // Ready with `ready_probability` from a seeded mt19937.
+    kReplay,       // Ready from `trace`, one entry per cycle, repeating.
+  };
+  Mode mode = kRandom;
+  int wait_states = kAxiWaitState;
+  uint32_t seed = 1;
+  double ready_probability = 0.5;
+  std::vector<bool> trace;
+};
+
+// Parses a profile given as "random", "ready", "wait[:N]",
+// "prng:SEED[:P]" with 0 < P <= 1, or "replay:PATH". A replay file holds
+// one '0' or '1' per cycle; anything else in it is ignored.
+inline bool ParseBusProfile(const std::string& spec, BusProfile* profile) {
+  const size_t colon = spec.find(':');
+  const std::string mode = spec.substr(0, colon);
+  const std::string args =
+      colon == std::string::npos ? "" : spec.substr(colon + 1);
+  *profile = BusProfile();
+  if (mode == "random" && args.empty()) {
+    profile->mode = BusProfile::kRandom;
+  } else if (mode == "ready" && args.empty()) {
+    profile->mode = BusProfile::kAlwaysReady;
+  } else if (mode == "wait") {
+    profile->mode = BusProfile::kWaitState;
+    if (!args.empty()) {
+      char* end;
+      profile->wait_states = strtol(args.c_str(), &end, 0);
+      if (*end || profile->wait_states < 0) {
+        printf("***ERROR bad wait states in bus profile '%s'\n",
+               spec.c_str());
+        return false;
+      }
+    }
+  } else if (mode == "prng" && !args.empty()) {
+    profile->mode = BusProfile::kSeeded;
+    char* end;
+    profile->seed = strtoul(args.c_str(), &end, 0);
+    bool bad = end == args.c_str();
+    if (*end == ':') {
+      // A bus that is never ready would hang the core, so P must be > 0.
+      const char* probability = end + 1;
+      profile->ready_probability = strtod(probability, &end);
+      bad |= end == probability || !(profile->ready_probability > 0);
+    }
+    if (bad || *end || profile->ready_probability > 1) {
+      printf("***ERROR bad seed or probability in bus profile '%s'\n",
+             spec.c_str());
+      return false;
+    }
+  } else if (mode == "replay" && !args.empty()) {
+    profile->mode = BusProfile::kReplay;
+    FILE* f = fopen(args.c_str(), "r");
+    if (f == nullptr) {
+      printf("***ERROR cannot open bus trace %s\n", args.c_str());
+      return false;
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+      if (c == '0' || c == '1') {
+        profile->trace.push_back(c == '1');
+      }
+    }
+    fclose(f);
+    if (profile->trace.empty()) {
+      printf("***ERROR bus trace %s is empty\n", args.c_str());
+      return false;
+    }
+  } else {
+    printf("***ERROR unknown bus profile '%s'\n", spec.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Per-bus ready generator for a BusProfile.
+class BusReady {
+ public:
+  void set_profile(const BusProfile& profile) {
+    profile_ = profile;
+    rng_.seed(profile.seed);
+    // Compare raw 32-bit draws so the sequence does not depend on how the
+    // standard library implements its distributions.
+    threshold_ = static_cast<uint64_t>(profile.ready_probability *
+                                       4294967296.0);
+    waited_ = 0;
+    replay_pos_ = 0;
+  }
+
+  // Ready for the next cycle, given whether the bus is requesting now.
+  bool next(bool valid) {
+    switch (profile_.mode) {
+      case BusProfile::kAlwaysReady:
+        return true;
+      case BusProfile::kWaitState:
+        if (!valid) {
+          waited_ = 0;
+          return false;
+        }
+        if (waited_ >= profile_.wait_states) {
+          waited_ = 0;
+          return true;
+        }
+        waited_++;
+        return false;
+      case BusProfile::kSeeded:
+        return rng_() < threshold_;
+      case BusProfile::kReplay: {
+        const bool ready = profile_.trace[replay_pos_];
+        replay_pos_ = (replay_pos_ + 1) % profile_.trace.size();
+        return ready;
+      }
+      case BusProfile::kRandom:
+      default:
+        return rand() & 1;
+    }
+  }
+
+ private:
+  BusProfile profile_;
+  std::mt19937 rng_;
+  uint64_t threshold_ = 0;
+  int waited_ = 0;
+  size_t replay_pos_ = 0;
+};
+
+#endif  // TESTS_VERILATOR_SIM_CORALNPU_BUS_PROFILE_H_
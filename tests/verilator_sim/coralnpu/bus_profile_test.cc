@@ -0,0 +1,113 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks bus profile parsing and pins the ready sequences of the
+// deterministic BusReady modes.
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "tests/verilator_sim/coralnpu/bus_profile.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+// Ready for `valid` ('1' or '0' per cycle) as a string of '1' and '0'.
+std::string Sequence(const BusProfile& profile, const std::string& valid) {
+  BusReady ready;
+  ready.set_profile(profile);
+  std::string out;
+  for (char c : valid) {
+    out += ready.next(c == '1') ? '1' : '0';
+  }
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+  BusProfile profile;
+
+  for (const char* bad : {"", "bogus", "ready:1", "random:1", "wait:x",
+                          "wait:-1", "prng", "prng:", "prng::0.5", "prng:x",
+                          "prng:5:", "prng:5:0", "prng:5:0.0", "prng:5:-0.5",
+                          "prng:5:1.5", "prng:5:abc", "replay:",
+                          "replay:/nonexistent/bus_trace"}) {
+    ok &= Check(!ParseBusProfile(bad, &profile), bad);
+  }
+
+  ok &= Check(ParseBusProfile("ready", &profile) &&
+                  profile.mode == BusProfile::kAlwaysReady,
+              "ready");
+  ok &= Check(Sequence(profile, "0101") == "1111", "ready sequence");
+
+  // wait:N is ready on the (N+1)th cycle of valid and restarts when valid
+  // drops.
+  ok &= Check(ParseBusProfile("wait", &profile) &&
+                  profile.mode == BusProfile::kWaitState &&
+                  profile.wait_states == kAxiWaitState,
+              "wait default");
+  ok &= Check(ParseBusProfile("wait:2", &profile) && profile.wait_states == 2,
+              "wait:2");
+  ok &= Check(Sequence(profile, "111111") == "001001", "wait:2 sequence");
+  ok &= Check(Sequence(profile, "1101110") == "0000010",
+              "wait:2 restarts");
+  ok &= Check(ParseBusProfile("wait:0", &profile) &&
+                  Sequence(profile, "1101") == "1101",
+              "wait:0 sequence");
+
+  // The seeded sequence depends only on mt19937, whatever valid does.
+  ok &= Check(ParseBusProfile("prng:5", &profile) &&
+                  profile.mode == BusProfile::kSeeded && profile.seed == 5 &&
+                  profile.ready_probability == 0.5,
+              "prng default probability");
+  ok &= Check(ParseBusProfile("prng:5:0.25", &profile) &&
+                  profile.ready_probability == 0.25,
+              "prng:5:0.25");
+  ok &= Check(Sequence(profile, std::string(24, '1')) ==
+                  "110010000100000000101000",
+              "prng:5:0.25 sequence");
+  ok &= Check(Sequence(profile, std::string(24, '0')) ==
+                  "110010000100000000101000",
+              "prng ignores valid");
+  ok &= Check(ParseBusProfile("prng:5:1", &profile) &&
+                  Sequence(profile, "1010") == "1111",
+              "prng:5:1 sequence");
+
+  // A replay trace keeps only its '0' and '1' characters and repeats.
+  char path[] = "/tmp/bus_profile_testXXXXXX";
+  int fd = mkstemp(path);
+  const std::string trace = "1 0\n0 1x1\n";
+  ok &= Check(write(fd, trace.data(), trace.size()) ==
+                  static_cast<ssize_t>(trace.size()),
+              "write trace");
+  close(fd);
+  ok &= Check(ParseBusProfile(std::string("replay:") + path, &profile) &&
+                  profile.mode == BusProfile::kReplay &&
+                  profile.trace.size() == 5,
+              "replay");
+  ok &= Check(Sequence(profile, "0000000") == "1001110", "replay sequence");
+  FILE* f = fopen(path, "w");
+  fputs("no ready values\n", f);
+  fclose(f);
+  ok &= Check(!ParseBusProfile(std::string("replay:") + path, &profile),
+              "empty replay trace");
+  unlink(path);
+
+  return TestResult(ok);
+}
@@ -16,31 +16,10 @@
 #define TESTS_VERILATOR_SIM_CORALNPU_CORE_IF_H_
 
 #include "tests/verilator_sim/fifo.h"
+#include "tests/verilator_sim/coralnpu/bus_profile.h"
 #include "tests/verilator_sim/coralnpu/coralnpu_cfg.h"
 #include "tests/verilator_sim/coralnpu/memory_if.h"
 
-constexpr int kAxiWaitState = 3;
-
-static bool rand_bool() {
-  return rand() & 1;
-}
-
-static bool rand_bool_ibus() {
-#if 1
-  return rand_bool();
-#else
-  return true;
-#endif
-}
-
-static bool rand_bool_dbus() {
-#if 1
-  return rand_bool();
-#else
-  return true;
-#endif
-}
-
 // ScalarCore Memory Interface.
 struct Core_if : Memory_if {
   sc_in<bool>         io_ibus_valid;
@@ -69,14 +48,19 @@ struct Core_if : Memory_if {
     }
   }
 
+  void set_bus_profiles(const BusProfile& ibus, const BusProfile& dbus) {
+    ibus_ready_.set_profile(ibus);
+    dbus_ready_.set_profile(dbus);
+  }
+
   void eval() {
     if (reset) {
       io_ibus_ready = false;
     } else if (clock->posedge()) {
       cycle_++;
 
-      io_ibus_ready = rand_bool_ibus();
-      io_dbus_ready = rand_bool_dbus();
+      io_ibus_ready = ibus_ready_.next(io_ibus_valid);
+      io_dbus_ready = dbus_ready_.next(io_dbus_valid);
 
       // Instruction bus read.
       if (io_ibus_valid && io_ibus_ready) {
@@ -139,6 +123,8 @@ struct Core_if : Memory_if {
 
  private:
   uint32_t cycle_ = 0;
+  BusReady ibus_ready_;
+  BusReady dbus_ready_;
 
   struct rtcm_t {
     uint32_t cycle;
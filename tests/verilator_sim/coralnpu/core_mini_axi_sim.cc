@@ -15,10 +15,20 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
@@ -26,7 +36,9 @@
 #include "absl/log/check.h"
 #include "absl/log/initialize.h"
 #include "absl/log/log.h"
+#include "absl/status/status.h"
 #include "tests/verilator_sim/coralnpu/core_mini_axi_tb.h"
+#include "tests/verilator_sim/elf.h"
 #include "tests/verilator_sim/sysc_tb.h"
 
 /* clang-format off */
@@ -35,45 +47,528 @@
 
 ABSL_FLAG(int, cycles, 100000000, "Simulation cycles");
 ABSL_FLAG(bool, trace, false, "Dump VCD trace");
+ABSL_FLAG(uint32_t, trace_start_cycle, 0, "First cycle written to the trace");
+ABSL_FLAG(uint32_t, trace_stop_cycle, UINT32_MAX,
+          "Cycle at which the trace stops");
+ABSL_FLAG(std::string, trace_start_pc, "",
+          "Start the trace when this PC (address or ELF symbol) issues");
+ABSL_FLAG(std::string, trace_stop_pc, "",
+          "Stop the trace when this PC (address or ELF symbol) issues");
+ABSL_FLAG(std::string, trace_marker, "",
+          "Address or ELF symbol that firmware writes nonzero to start the "
+          "trace and zero to stop it");
+ABSL_FLAG(int, trace_flush_edges, 4096,
+          "Clock edges buffered before the trace is flushed to disk");
 ABSL_FLAG(std::string, binary, "", "Binary to execute");
+ABSL_FLAG(std::string, batch, "",
+          "File listing binaries to run one after another on one testbench, "
+          "one per line; --cycles then limits each binary");
+ABSL_FLAG(std::string, load_mode, "verify",
+          "How the binary is loaded: verify (AXI write, read back and "
+          "compare), write_only (AXI write), crc (AXI write, then CRC "
+          "compare through the SRAM backdoor) or backdoor (no AXI traffic)");
+ABSL_FLAG(uint64_t, extmem_size, Xbar::kDefaultMemorySizeBytes,
+          "Size in bytes of the external memory at 0x20000000, which must "
+          "end below the UART at 0x54000000; pages are allocated as they are "
+          "touched");
+ABSL_FLAG(std::vector<std::string>, extmem_file, std::vector<std::string>(),
+          "Files to map into the external memory before the run, as "
+          "path@address; mapped pages are copy-on-write");
+ABSL_FLAG(uint32_t, extmem_latency, 0,
+          "External memory cycles from request to first byte on a row hit");
+ABSL_FLAG(uint32_t, extmem_row_miss_latency, 0,
+          "Extra external memory cycles when a new row must be opened");
+ABSL_FLAG(uint32_t, extmem_row_bytes, 0,
+          "External memory row size in bytes; 0 disables the row model");
+ABSL_FLAG(uint32_t, extmem_banks, 1,
+          "External memory banks, each with one open row");
+ABSL_FLAG(uint32_t, extmem_bytes_per_cycle, 0,
+          "External memory data bandwidth; 0 is unlimited");
+ABSL_FLAG(uint32_t, extmem_max_outstanding, 0,
+          "External memory requests in flight at once; 0 is unlimited");
 ABSL_FLAG(bool, debug_axi, false, "Enable AXI traffic debugging");
 ABSL_FLAG(bool, instr_trace, false, "Log instructions to console");
+ABSL_FLAG(std::string, instr_trace_file, "",
+          "Stream committed instructions to this binary trace instead; "
+          "convert it with instruction_trace_to_csv");
+ABSL_FLAG(bool, instr_trace_compress, false,
+          "Compress the --instr_trace_file blocks");
+ABSL_FLAG(std::string, save_checkpoint, "",
+          "Save a checkpoint to this path when the core first enters WFI");
+ABSL_FLAG(std::string, restore_checkpoint, "",
+          "Start from this checkpoint instead of loading --binary");
+ABSL_FLAG(std::string, stats_json, "",
+          "Write cycles, ELF load time and run time as JSON to this path");
+
+namespace {
+
+struct RunStats {
+  bool halted = false;
+  uint32_t cycles = 0;
+  double load_seconds = 0;
+  double run_seconds = 0;
+};
+
+bool WriteStats(const std::string& path, const std::string& binary,
+                const RunStats& stats) {
+  FILE* f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f,
+          "{\"model\": \"%s\", \"binary\": \"%s\", \"halted\": %s, "
+          "\"cycles\": %u, \"load_seconds\": %.6f, \"run_seconds\": %.6f}\n",
+          CoreMiniAxi_tb::kCoreMiniAxiModelName, binary.c_str(),
+          stats.halted ? "true" : "false", stats.cycles, stats.load_seconds,
+          stats.run_seconds);
+  return fclose(f) == 0;
+}
+
+enum class BatchStatus { kPass, kFail, kTimeout, kLoadFail };
+
+const char* BatchStatusName(BatchStatus status) {
+  switch (status) {
+    case BatchStatus::kPass:
+      return "PASS";
+    case BatchStatus::kFail:
+      return "FAIL";
+    case BatchStatus::kTimeout:
+      return "TIMEOUT";
+    case BatchStatus::kLoadFail:
+      return "LOAD_FAIL";
+  }
+  return "UNKNOWN";
+}
+
+struct BatchResult {
+  std::string binary;
+  BatchStatus status = BatchStatus::kLoadFail;
+  RunStats stats;
+};
+
+bool WriteBatchStats(const std::string& path,
+                     const std::vector<BatchResult>& results) {
+  FILE* f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "{\"model\": \"%s\", \"results\": [",
+          CoreMiniAxi_tb::kCoreMiniAxiModelName);
+  for (size_t i = 0; i < results.size(); i++) {
+    const BatchResult& result = results[i];
+    fprintf(f,
+            "%s\n  {\"binary\": \"%s\", \"status\": \"%s\", "
+            "\"passed\": %s, \"halted\": %s, \"cycles\": %u, "
+            "\"load_seconds\": %.6f, \"run_seconds\": %.6f}",
+            i ? "," : "", result.binary.c_str(),
+            BatchStatusName(result.status),
+            result.status == BatchStatus::kPass ? "true" : "false",
+            result.stats.halted ? "true" : "false", result.stats.cycles,
+            result.stats.load_seconds, result.stats.run_seconds);
+  }
+  fprintf(f, "\n]}\n");
+  return fclose(f) == 0;
+}
+
+// Reads the binaries listed in `path`, skipping blank lines and # comments.
+std::vector<std::string> ReadBatch(const std::string& path) {
+  std::vector<std::string> binaries;
+  std::ifstream is(path);
+  CHECK(is.is_open()) << "Could not open " << path;
+  std::string line;
+  while (std::getline(is, line)) {
+    line = line.substr(0, line.find('#'));
+    const size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+      continue;
+    }
+    const size_t end = line.find_last_not_of(" \t\r");
+    binaries.push_back(line.substr(begin, end - begin + 1));
+  }
+  return binaries;
+}
+
+struct ExternalMemoryConfig {
+  uint64_t size_bytes = Xbar::kDefaultMemorySizeBytes;
+  // (address, path) of files mapped into the memory.
+  std::vector<std::pair<uint32_t, std::string>> files;
+  MemoryTiming timing;
+};
+
+std::optional<ExternalMemoryConfig> ParseExternalMemoryConfig(
+    uint64_t size_bytes, const std::vector<std::string>& files) {
+  if (size_bytes > Xbar::kMaxMemorySizeBytes) {
+    LOG(ERROR) << "--extmem_size " << size_bytes << " overlaps the UART; "
+               << "at most " << Xbar::kMaxMemorySizeBytes << " bytes fit";
+    return std::nullopt;
+  }
+  ExternalMemoryConfig config;
+  config.size_bytes = size_bytes;
+  for (const std::string& file : files) {
+    const size_t at = file.rfind('@');
+    if (at == std::string::npos) {
+      LOG(ERROR) << "--extmem_file " << file << " is not path@address";
+      return std::nullopt;
+    }
+    char* end;
+    const std::string addr = file.substr(at + 1);
+    const unsigned long value = strtoul(addr.c_str(), &end, 0);  // NOLINT
+    if (addr.empty() || *end != '\0') {
+      LOG(ERROR) << "--extmem_file " << file << " has a bad address";
+      return std::nullopt;
+    }
+    config.files.emplace_back(value, file.substr(0, at));
+  }
+  return config;
+}
+
+// Sets up the tb's external memory, timed in cycles of the tb's clock, with
+// only the configured files in it.
+bool ConfigureExternalMemory(CoreMiniAxi_tb& tb,
+                             const ExternalMemoryConfig& config) {
+  Xbar& xbar = tb.xbar();
+  xbar.memory().Clear();
+  xbar.memory().Resize(config.size_bytes);
+  xbar.set_memory_timing(config.timing, tb.clock.period());
+  for (const auto& [addr, path] : config.files) {
+    if (addr < Xbar::memory_addr() ||
+        !xbar.memory().MapFile(addr - Xbar::memory_addr(), path)) {
+      LOG(ERROR) << "Could not map " << path << " at 0x" << std::hex << addr
+                 << "; it must fit the memory at a 64 KiB aligned address";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Prints the traffic the external memory served and how well the timing
+// model let it flow.
+void ReportExternalMemory(const MemoryStats& stats) {
+  if (stats.reads + stats.writes == 0) {
+    return;
+  }
+  printf("External memory: %lu reads (%lu bytes), %lu writes (%lu bytes)\n",
+         static_cast<unsigned long>(stats.reads),
+         static_cast<unsigned long>(stats.read_bytes),
+         static_cast<unsigned long>(stats.writes),
+         static_cast<unsigned long>(stats.write_bytes));
+  if (stats.row_hits + stats.row_misses) {
+    printf("  row hits %lu, misses %lu\n",
+           static_cast<unsigned long>(stats.row_hits),
+           static_cast<unsigned long>(stats.row_misses));
+  }
+  printf("  %.3f bytes/cycle over %lu active cycles, %lu stall cycles\n",
+         stats.bytes_per_cycle(),
+         static_cast<unsigned long>(stats.active_cycles),
+         static_cast<unsigned long>(stats.stall_cycles));
+}
+
+std::optional<CoreMiniAxi_tb::LoadMode> ParseLoadMode(
+    const std::string& value) {
+  if (value == "verify") {
+    return CoreMiniAxi_tb::LoadMode::kVerify;
+  } else if (value == "write_only") {
+    return CoreMiniAxi_tb::LoadMode::kWriteOnly;
+  } else if (value == "crc") {
+    return CoreMiniAxi_tb::LoadMode::kWriteOnlyCrc;
+  } else if (value == "backdoor") {
+    return CoreMiniAxi_tb::LoadMode::kBackdoor;
+  }
+  return std::nullopt;
+}
+
+// Parses `value` as a number, returning std::nullopt if it is not one.
+std::optional<uint32_t> ParseAddress(const std::string& value) {
+  if (value.empty()) {
+    return std::nullopt;
+  }
+  char* end;
+  const unsigned long addr = strtoul(value.c_str(), &end, 0);  // NOLINT
+  if (*end != '\0') {
+    return std::nullopt;
+  }
+  return addr;
+}
+
+// Returns false, after logging why, if `value` of `flag` is set but is not
+// a number. ELF symbols cannot be resolved for a whole batch.
+bool CheckBatchAddress(const char* flag, const std::string& value) {
+  if (!value.empty() && !ParseAddress(value).has_value()) {
+    LOG(ERROR) << flag << " must be an address with --batch, not " << value;
+    return false;
+  }
+  return true;
+}
+
+// Resolves `value` as a number, or else as a symbol of the ELF `binary`.
+std::optional<uint32_t> ResolveAddress(const std::string& binary,
+                                       const std::string& value) {
+  if (value.empty()) {
+    return std::nullopt;
+  }
+  if (auto addr = ParseAddress(value)) {
+    return addr;
+  }
+  int fd = open(binary.c_str(), 0);
+  CHECK(fd >= 0) << "--binary is required to resolve " << value;
+  struct stat sb;
+  CHECK(fstat(fd, &sb) == 0);
+  auto file_data = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  CHECK(file_data != MAP_FAILED);
+  close(fd);
+  uint32_t symbol_addr;
+  const bool found = ::LookupSymbol(reinterpret_cast<uint8_t*>(file_data),
+                                    value, &symbol_addr);
+  munmap(file_data, sb.st_size);
+  CHECK(found) << value << " not found in " << binary;
+  return symbol_addr;
+}
+
+// Sends the tb's instruction trace to `path`, if set.
+bool StreamInstructionTrace(CoreMiniAxi_tb& tb, const std::string& path,
+                            bool compress) {
+  if (path.empty()) {
+    return true;
+  }
+  if (!tb.instruction_trace().StreamTo(path, compress)) {
+    LOG(ERROR) << "Failed to open " << path;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
 
 static bool run(const char* name, const std::string binary, const int cycles,
-                const bool trace, const bool debug_axi, const bool instr_trace) {
+                const bool trace, const TraceOptions& trace_options,
+                const bool debug_axi, const bool instr_trace,
+                const std::string instr_trace_file,
+                const bool instr_trace_compress,
+                const std::string save_checkpoint,
+                const std::string restore_checkpoint,
+                const std::string stats_json,
+                const CoreMiniAxi_tb::LoadMode load_mode,
+                const ExternalMemoryConfig& extmem) {
   absl::Mutex halted_mtx;
   absl::CondVar halted_cv;
+  // Set when the core halts, or when the simulation ends without halting
+  // because the cycle limit was reached.
+  bool halted = false;
+  bool sim_ended = false;
+  std::optional<std::function<void()>> wfi_cb;
+  bool checkpoint_saved = false;
+  CoreMiniAxi_tb* tb_ptr = nullptr;
+  if (!save_checkpoint.empty()) {
+    wfi_cb = [&tb_ptr, &checkpoint_saved, save_checkpoint]() {
+      if (!checkpoint_saved) {
+        CHECK_OK(tb_ptr->SaveCheckpoint(save_checkpoint));
+        checkpoint_saved = true;
+      }
+    };
+  }
   CoreMiniAxi_tb tb(CoreMiniAxi_tb::kCoreMiniAxiModelName, cycles, /* random= */ false, debug_axi,
-                    instr_trace,
-                    /*wfi_cb=*/std::nullopt,
-                    /*halted_cb=*/[&halted_mtx, &halted_cv]() {
+                    instr_trace || !instr_trace_file.empty(),
+                    wfi_cb,
+                    /*halted_cb=*/[&halted_mtx, &halted_cv, &halted]() {
                       absl::MutexLock lock_(&halted_mtx);
+                      halted = true;
                       halted_cv.SignalAll();
                     });
+  tb_ptr = &tb;
+  if (!ConfigureExternalMemory(tb, extmem) ||
+      !StreamInstructionTrace(tb, instr_trace_file, instr_trace_compress)) {
+    return false;
+  }
   if (trace) {
-    tb.trace(tb.core());
+    tb.trace(tb.core(), trace_options);
   }
 
-  std::thread sc_main_thread([&tb]() { tb.start(); });
+  std::thread sc_main_thread([&tb, &halted_mtx, &halted_cv, &sim_ended]() {
+    tb.start();
+    absl::MutexLock lock_(&halted_mtx);
+    sim_ended = true;
+    halted_cv.SignalAll();
+  });
 
-  CHECK_OK(tb.LoadElfSync(binary));
-  CHECK_OK(tb.ClockGateSync(false));
-  CHECK_OK(tb.ResetAsync(false));
+  RunStats stats;
+  const auto start = std::chrono::steady_clock::now();
+  if (restore_checkpoint.empty()) {
+    // Only the verifying load reads back the CSR writes.
+    const bool verify = load_mode == CoreMiniAxi_tb::LoadMode::kVerify;
+    const absl::Status status = tb.LoadElfSync(binary, load_mode);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to load " << binary << ": " << status;
+      sc_stop();
+      sc_main_thread.join();
+      return false;
+    }
+    CHECK_OK(tb.ClockGateSync(false, verify));
+    CHECK_OK(tb.ResetAsync(false, verify));
+  } else {
+    const absl::Status status = tb.RestoreCheckpointSync(restore_checkpoint);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to restore " << restore_checkpoint << ": "
+                 << status;
+      sc_stop();
+      sc_main_thread.join();
+      return false;
+    }
+  }
+  const auto loaded = std::chrono::steady_clock::now();
 
   {
     absl::MutexLock lock_(&halted_mtx);
-    halted_cv.Wait(&halted_mtx);
+    while (!halted && !sim_ended) {
+      halted_cv.Wait(&halted_mtx);
+    }
+    stats.halted = halted;
   }
+  const auto finished = std::chrono::steady_clock::now();
 
-  if (!tb.io_fault && !tb.tohost_halt) {
+  if (stats.halted && !tb.io_fault && !tb.tohost_halt) {
     CHECK_OK(tb.CheckStatusSync());
   }
 
   sc_stop();
   sc_main_thread.join();
+
+  ReportExternalMemory(tb.xbar().memory_stats());
+  stats.cycles = tb.cycles();
+  stats.load_seconds = std::chrono::duration<double>(loaded - start).count();
+  stats.run_seconds = std::chrono::duration<double>(finished - loaded).count();
+  if (!stats_json.empty() && !WriteStats(stats_json, binary, stats)) {
+    LOG(ERROR) << "Failed to write " << stats_json;
+  }
+  if (!stats.halted) {
+    LOG(WARNING) << "Cycle limit reached before the core halted";
+    return false;
+  }
   return (!tb.io_fault && !(tb.tohost_halt && tb.tohost_val != 1));
 }
 
+// Runs each of `binaries` on one testbench, resetting the core between them
+// instead of elaborating a new one, and reports pass/fail and cycles for
+// each.
+static bool run_batch(const std::vector<std::string>& binaries,
+                      const int cycles, const bool trace,
+                      const TraceOptions& trace_options, const bool debug_axi,
+                      const bool instr_trace,
+                      const std::string instr_trace_file,
+                      const bool instr_trace_compress,
+                      const std::string stats_json,
+                      const CoreMiniAxi_tb::LoadMode load_mode,
+                      const ExternalMemoryConfig& extmem) {
+  absl::Mutex halted_mtx;
+  absl::CondVar halted_cv;
+  bool halted = false;
+  bool sim_ended = false;
+  CoreMiniAxi_tb tb(CoreMiniAxi_tb::kCoreMiniAxiModelName,
+                    std::numeric_limits<int>::max(), /* random= */ false,
+                    debug_axi, instr_trace || !instr_trace_file.empty(),
+                    /*wfi_cb=*/std::nullopt,
+                    /*halted_cb=*/[&halted_mtx, &halted_cv, &halted]() {
+                      absl::MutexLock lock_(&halted_mtx);
+                      halted = true;
+                      halted_cv.SignalAll();
+                    });
+  if (!ConfigureExternalMemory(tb, extmem) ||
+      !StreamInstructionTrace(tb, instr_trace_file, instr_trace_compress)) {
+    return false;
+  }
+  if (trace) {
+    tb.trace(tb.core(), trace_options);
+  }
+
+  std::thread sc_main_thread([&tb, &halted_mtx, &halted_cv, &sim_ended]() {
+    tb.start();
+    absl::MutexLock lock_(&halted_mtx);
+    sim_ended = true;
+    halted_cv.SignalAll();
+  });
+
+  const bool verify = load_mode == CoreMiniAxi_tb::LoadMode::kVerify;
+  std::vector<BatchResult> results;
+  bool all_passed = true;
+  for (const std::string& binary : binaries) {
+    BatchResult result;
+    result.binary = binary;
+    const auto start = std::chrono::steady_clock::now();
+    CHECK_OK(tb.ResetProgramSync(cycles));
+    // Nothing reaches the Xbar while the core is held in reset, so the
+    // memory can be refilled from this thread. Each program then sees the
+    // external memory as a single run would.
+    if (!ConfigureExternalMemory(tb, extmem)) {
+      all_passed = false;
+      break;
+    }
+    {
+      absl::MutexLock lock_(&halted_mtx);
+      halted = false;
+    }
+    const uint32_t start_cycles = tb.cycles();
+    const absl::Status status = tb.LoadElfSync(binary, load_mode);
+    if (status.ok()) {
+      CHECK_OK(tb.ClockGateSync(false, verify));
+      CHECK_OK(tb.ResetAsync(false, verify));
+    } else {
+      LOG(ERROR) << "Failed to load " << binary << ": " << status;
+    }
+    const auto loaded = std::chrono::steady_clock::now();
+
+    bool ended = false;
+    if (status.ok()) {
+      absl::MutexLock lock_(&halted_mtx);
+      while (!halted && !sim_ended) {
+        halted_cv.Wait(&halted_mtx);
+      }
+      result.stats.halted = halted && !tb.cycle_limit_reached();
+      ended = sim_ended;
+    }
+    const auto finished = std::chrono::steady_clock::now();
+    if (ended) {
+      LOG(ERROR) << "Simulation ended while running " << binary;
+      all_passed = false;
+      break;
+    }
+    if (result.stats.halted && !tb.io_fault && !tb.tohost_halt) {
+      CHECK_OK(tb.CheckStatusSync());
+    }
+
+    if (!status.ok()) {
+      result.status = BatchStatus::kLoadFail;
+    } else if (!result.stats.halted) {
+      result.status = BatchStatus::kTimeout;
+    } else if (tb.io_fault || (tb.tohost_halt && tb.tohost_val != 1)) {
+      result.status = BatchStatus::kFail;
+    } else {
+      result.status = BatchStatus::kPass;
+    }
+    result.stats.cycles = tb.cycles() - start_cycles;
+    result.stats.load_seconds =
+        std::chrono::duration<double>(loaded - start).count();
+    result.stats.run_seconds =
+        std::chrono::duration<double>(finished - loaded).count();
+    printf("%-9s %12u cycles  %s\n", BatchStatusName(result.status),
+           result.stats.cycles, binary.c_str());
+    all_passed &= result.status == BatchStatus::kPass;
+    results.push_back(result);
+  }
+
+  sc_stop();
+  sc_main_thread.join();
+
+  int passed = 0;
+  for (const BatchResult& result : results) {
+    passed += result.status == BatchStatus::kPass;
+  }
+  printf("%d of %zu binaries passed\n", passed, binaries.size());
+  ReportExternalMemory(tb.xbar().memory_stats());
+  if (!stats_json.empty() && !WriteBatchStats(stats_json, results)) {
+    LOG(ERROR) << "Failed to write " << stats_json;
+  }
+  return all_passed && results.size() == binaries.size();
+}
+
 extern "C" int sc_main(int argc, char** argv) {
   absl::InitializeLog();
   absl::SetProgramUsageMessage("CoreMiniAxi simulator");
@@ -81,12 +576,78 @@ extern "C" int sc_main(int argc, char** argv) {
   argc = args.size();
   argv = &args[0];
 
-  if (absl::GetFlag(FLAGS_binary) == "") {
+  if (absl::GetFlag(FLAGS_binary) == "" &&
+      absl::GetFlag(FLAGS_restore_checkpoint) == "" &&
+      absl::GetFlag(FLAGS_batch) == "") {
     LOG(ERROR) << "--binary is required!";
     return -1;
   }
 
-  return run(Sysc_tb::get_name(argv[0]), absl::GetFlag(FLAGS_binary),
-      absl::GetFlag(FLAGS_cycles), absl::GetFlag(FLAGS_trace),
-      absl::GetFlag(FLAGS_debug_axi), absl::GetFlag(FLAGS_instr_trace)) ? 0 : 1;
+  const std::string binary = absl::GetFlag(FLAGS_binary);
+  const auto load_mode = ParseLoadMode(absl::GetFlag(FLAGS_load_mode));
+  if (!load_mode.has_value()) {
+    LOG(ERROR) << "Unknown --load_mode " << absl::GetFlag(FLAGS_load_mode);
+    return -1;
+  }
+  auto extmem = ParseExternalMemoryConfig(
+      absl::GetFlag(FLAGS_extmem_size), absl::GetFlag(FLAGS_extmem_file));
+  if (!extmem.has_value()) {
+    return -1;
+  }
+  extmem->timing.latency_cycles = absl::GetFlag(FLAGS_extmem_latency);
+  extmem->timing.row_miss_cycles =
+      absl::GetFlag(FLAGS_extmem_row_miss_latency);
+  extmem->timing.row_bytes = absl::GetFlag(FLAGS_extmem_row_bytes);
+  extmem->timing.banks = absl::GetFlag(FLAGS_extmem_banks);
+  extmem->timing.bytes_per_cycle = absl::GetFlag(FLAGS_extmem_bytes_per_cycle);
+  extmem->timing.max_outstanding = absl::GetFlag(FLAGS_extmem_max_outstanding);
+  const bool batch = !absl::GetFlag(FLAGS_batch).empty();
+  if (batch && (!absl::GetFlag(FLAGS_save_checkpoint).empty() ||
+                !absl::GetFlag(FLAGS_restore_checkpoint).empty())) {
+    LOG(ERROR) << "--save_checkpoint and --restore_checkpoint cannot be "
+                  "used with --batch";
+    return -1;
+  }
+  if (batch &&
+      (!CheckBatchAddress("--trace_start_pc",
+                          absl::GetFlag(FLAGS_trace_start_pc)) ||
+       !CheckBatchAddress("--trace_stop_pc",
+                          absl::GetFlag(FLAGS_trace_stop_pc)) ||
+       !CheckBatchAddress("--trace_marker",
+                          absl::GetFlag(FLAGS_trace_marker)))) {
+    return -1;
+  }
+  TraceOptions trace_options;
+  trace_options.start_cycle = absl::GetFlag(FLAGS_trace_start_cycle);
+  trace_options.stop_cycle = absl::GetFlag(FLAGS_trace_stop_cycle);
+  trace_options.start_pc =
+      ResolveAddress(binary, absl::GetFlag(FLAGS_trace_start_pc));
+  trace_options.stop_pc =
+      ResolveAddress(binary, absl::GetFlag(FLAGS_trace_stop_pc));
+  trace_options.marker_addr =
+      ResolveAddress(binary, absl::GetFlag(FLAGS_trace_marker));
+  trace_options.flush_edges = absl::GetFlag(FLAGS_trace_flush_edges);
+
+  if (batch) {
+    return run_batch(ReadBatch(absl::GetFlag(FLAGS_batch)),
+                     absl::GetFlag(FLAGS_cycles), absl::GetFlag(FLAGS_trace),
+                     trace_options, absl::GetFlag(FLAGS_debug_axi),
+                     absl::GetFlag(FLAGS_instr_trace),
+                     absl::GetFlag(FLAGS_instr_trace_file),
+                     absl::GetFlag(FLAGS_instr_trace_compress),
+                     absl::GetFlag(FLAGS_stats_json), load_mode.value(),
+                     extmem.value())
+               ? 0
+               : 1;
+  }
+
+  return run(Sysc_tb::get_name(argv[0]), binary,
+      absl::GetFlag(FLAGS_cycles), absl::GetFlag(FLAGS_trace), trace_options,
+      absl::GetFlag(FLAGS_debug_axi), absl::GetFlag(FLAGS_instr_trace),
+      absl::GetFlag(FLAGS_instr_trace_file),
+      absl::GetFlag(FLAGS_instr_trace_compress),
+      absl::GetFlag(FLAGS_save_checkpoint),
+      absl::GetFlag(FLAGS_restore_checkpoint),
+      absl::GetFlag(FLAGS_stats_json), load_mode.value(),
+      extmem.value()) ? 0 : 1;
 }
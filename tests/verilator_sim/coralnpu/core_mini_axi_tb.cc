@@ -22,12 +22,18 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/crc/crc32c.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "tests/verilator_sim/elf.h"
 #include "tests/verilator_sim/sysc_tb.h"
+#include "verilated_save.h"  // NOLINT(build/include_subdir): From verilator.
 
 /* clang-format off */
 #include <systemc>
@@ -59,6 +65,10 @@ CoreMiniAxi_tb::CoreMiniAxi_tb(sc_module_name n, int loops, bool random,
     CHECK(false);
   }
   CoreMiniAxi_tb::singleton_ = this;
+#ifdef VERILATOR_THREADS
+  // Models verilated with --threads N need a context with N threads.
+  Verilated::defaultContextp()->threads(VERILATOR_THREADS);
+#endif
   core_ = std::make_unique<VERILATOR_MODEL>("core");
 
   // TLM2AXI
@@ -278,23 +288,61 @@ void CoreMiniAxi_tb::Connect() {
   core_->io_axi_slave_write_resp_bits_resp(tlm2axi_signals_.bresp);
 }
 
-absl::Status CoreMiniAxi_tb::LoadElfSync(const std::string& file_name) {
-  CHECK_OK(LoadElfAsync(file_name));
+absl::Status CoreMiniAxi_tb::LoadElfSync(const std::string& file_name,
+                                         LoadMode mode) {
+  absl::Status status = LoadElfAsync(file_name, mode);
+  if (!status.ok()) {
+    return status;
+  }
   absl::MutexLock lock(&transfer_queue_mtx_);
-  transfer_queue_cv_.Wait(&transfer_queue_mtx_);
-  return absl::OkStatus();
+  while (transfer_in_progress_ || !transfer_queue_.empty() ||
+         !sim_thread_ops_.empty()) {
+    transfer_queue_cv_.Wait(&transfer_queue_mtx_);
+  }
+  return load_status_;
 }
 
-absl::Status CoreMiniAxi_tb::LoadElfAsync(const std::string& file_name) {
+absl::Status CoreMiniAxi_tb::LoadElfAsync(const std::string& file_name,
+                                          LoadMode mode) {
   absl::MutexLock lock(&transfer_queue_mtx_);
+  load_status_ = absl::OkStatus();
   int fd = open(file_name.c_str(), 0);
-  CHECK(fd > 0);
+  if (fd < 0) {
+    return absl::NotFoundError("Could not open " + file_name);
+  }
   struct stat sb;
   CHECK(fstat(fd, &sb) == 0);
   auto file_size = sb.st_size;
   auto file_data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
-  CHECK(file_data != MAP_FAILED);
   close(fd);
+  if (file_data == MAP_FAILED) {
+    return absl::InvalidArgumentError("Could not map " + file_name);
+  }
+
+  // Segments copied through the backdoor (kBackdoor) or checked through it
+  // after the AXI writes (kWriteOnlyCrc).
+  struct Segment {
+    uint32_t addr;
+    std::vector<uint8_t> data;
+  };
+  std::vector<Segment> segments;
+  auto load_segment = [this, mode, &segments](
+                          std::vector<DataTransfer>& transfers, uint32_t addr,
+                          uint8_t* src, size_t count) {
+    const bool backdoor = BackdoorContains(addr, count);
+    if (backdoor && (mode == LoadMode::kBackdoor ||
+                     mode == LoadMode::kWriteOnlyCrc)) {
+      segments.push_back({addr, std::vector<uint8_t>(src, src + count)});
+    }
+    if (backdoor && mode == LoadMode::kBackdoor) {
+      return;
+    }
+    transfers.push_back(utils::Write(addr, src, count));
+    if (mode == LoadMode::kVerify) {
+      transfers.push_back(utils::Read(addr, count));
+      transfers.push_back(utils::Expect(src, count));
+    }
+  };
 
   uint32_t elf_magic = 0x464c457f;
   uint8_t* data8 = reinterpret_cast<uint8_t*>(file_data);
@@ -305,17 +353,13 @@ absl::Status CoreMiniAxi_tb::LoadElfAsync(const std::string& file_name) {
     // Reserve space for write+read+expect for each section, and one additional
     // for the entry point CSR.
     elf_transfers.reserve(3 * elf_header->e_phnum + 1);
-    ::LoadElf(data8,
-              [&elf_transfers](void* dest, const void* src, size_t count) {
-                elf_transfers.push_back(utils::Write(
-                    reinterpret_cast<uint64_t>(dest),
-                    reinterpret_cast<uint8_t*>(const_cast<void*>(src)), count));
-                elf_transfers.push_back(
-                    utils::Read(reinterpret_cast<uint64_t>(dest), count));
-                elf_transfers.push_back(utils::Expect(
-                    reinterpret_cast<uint8_t*>(const_cast<void*>(src)), count));
-                return dest;
-              });
+    ::LoadElf(data8, [&elf_transfers, &load_segment](
+                         void* dest, const void* src, size_t count) {
+      load_segment(elf_transfers,
+                   static_cast<uint32_t>(reinterpret_cast<uint64_t>(dest)),
+                   reinterpret_cast<uint8_t*>(const_cast<void*>(src)), count);
+      return dest;
+    });
     elf_transfers.push_back(utils::Write(
       csr_addr_ + 0x4, reinterpret_cast<uint8_t*>(&entry_point), sizeof(entry_point)
     ));
@@ -333,50 +377,162 @@ absl::Status CoreMiniAxi_tb::LoadElfAsync(const std::string& file_name) {
     }
   } else {
     // Transaction to fill ITCM with the provided binary.
-    transfer_queue_.push(
-        std::make_unique<TrafficDesc>(utils::merge(std::vector<DataTransfer>(
-            {utils::Write(0, data8, file_size), utils::Read(0, file_size),
-             utils::Expect(data8, file_size)}))));
+    std::vector<DataTransfer> transfers;
+    load_segment(transfers, 0, data8, file_size);
+    if (!transfers.empty()) {
+      transfer_queue_.push(
+          std::make_unique<TrafficDesc>(utils::merge(transfers)));
+    }
   }
   munmap(file_data, file_size);
+
+  if (!segments.empty()) {
+    sim_thread_ops_.push([this, mode, segments = std::move(segments)]() {
+      for (const Segment& segment : segments) {
+        if (mode == LoadMode::kBackdoor) {
+          CHECK(BackdoorWrite(segment.addr, segment.data));
+          continue;
+        }
+        std::vector<uint8_t> actual(segment.data.size());
+        CHECK(BackdoorRead(segment.addr, absl::MakeSpan(actual)));
+        auto crc = [](const std::vector<uint8_t>& data) {
+          return absl::ComputeCrc32c(absl::string_view(
+              reinterpret_cast<const char*>(data.data()), data.size()));
+        };
+        if (crc(actual) != crc(segment.data)) {
+          load_status_ = absl::DataLossError(absl::StrFormat(
+              "CRC mismatch in the %u bytes loaded at 0x%08x",
+              segment.data.size(), segment.addr));
+          LOG(ERROR) << load_status_;
+          return;
+        }
+      }
+    });
+  }
   return absl::OkStatus();
 }
 
-absl::Status CoreMiniAxi_tb::ClockGateSync(bool enable) {
-  CHECK_OK(ClockGateAsync(enable));
+bool CoreMiniAxi_tb::BackdoorContains(uint32_t addr, size_t len) {
+  auto contains = [addr, len](uint64_t base, uint64_t size) {
+    return addr >= base && addr + len <= base + size;
+  };
+  return contains(itcm_addr_, itcm_size_) ||
+         contains(dtcm_addr_, dtcm_size_) ||
+         contains(Xbar::memory_addr(), xbar_.memory_size());
+}
+
+TcmBackdoor* CoreMiniAxi_tb::FindTcm(uint32_t addr, size_t len) {
+  if (!itcm_backdoor_) {
+    // The model's scope, e.g. "<tb>.core", then the Chisel top module.
+    const std::string top =
+        std::string(core_->name()) + "." + (kCoreMiniAxiModelName + 1);
+    itcm_backdoor_ =
+        std::make_unique<TcmBackdoor>(top + ".itcm", itcm_addr_, itcm_size_);
+    dtcm_backdoor_ =
+        std::make_unique<TcmBackdoor>(top + ".dtcm", dtcm_addr_, dtcm_size_);
+  }
+  for (TcmBackdoor* tcm : {itcm_backdoor_.get(), dtcm_backdoor_.get()}) {
+    if (tcm->Contains(addr, len)) {
+      return tcm;
+    }
+  }
+  return nullptr;
+}
+
+bool CoreMiniAxi_tb::InMemory(uint32_t addr, size_t len) {
+  return addr >= Xbar::memory_addr() &&
+         xbar_.memory().Contains(addr - Xbar::memory_addr(), len);
+}
+
+bool CoreMiniAxi_tb::BackdoorWrite(uint32_t addr,
+                                   absl::Span<const uint8_t> data) {
+  if (TcmBackdoor* tcm = FindTcm(addr, data.size())) {
+    tcm->Write(addr, data);
+  } else if (InMemory(addr, data.size())) {
+    xbar_.memory().Write(addr - Xbar::memory_addr(), data.data(),
+                         data.size());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool CoreMiniAxi_tb::BackdoorRead(uint32_t addr, absl::Span<uint8_t> data) {
+  if (TcmBackdoor* tcm = FindTcm(addr, data.size())) {
+    tcm->Read(addr, data);
+  } else if (InMemory(addr, data.size())) {
+    xbar_.memory().Read(addr - Xbar::memory_addr(), data.data(), data.size());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+absl::Status CoreMiniAxi_tb::ClockGateSync(bool enable, bool verify) {
+  CHECK_OK(ClockGateAsync(enable, verify));
   absl::MutexLock lock(&transfer_queue_mtx_);
   transfer_queue_cv_.Wait(&transfer_queue_mtx_);
   return absl::OkStatus();
 }
 
-absl::Status CoreMiniAxi_tb::ClockGateAsync(bool enable) {
+absl::Status CoreMiniAxi_tb::ClockGateAsync(bool enable, bool verify) {
   absl::MutexLock lock(&transfer_queue_mtx_);
   uint8_t enable8 = enable ? 3 : 1;
   uint8_t enable_[4] = { enable8, 0, 0, 0 };;
+  std::vector<DataTransfer> transfers = {utils::Write(csr_addr_, enable_)};
+  if (verify) {
+    transfers.push_back(utils::Read(csr_addr_, 4));
+    transfers.push_back(utils::Expect(enable_, 4));
+  }
   transfer_queue_.push(
-      std::make_unique<TrafficDesc>(utils::merge(std::vector<DataTransfer>(
-          {utils::Write(csr_addr_, enable_),
-           utils::Read(csr_addr_, 4),
-           utils::Expect(enable_, 4)}))));
+      std::make_unique<TrafficDesc>(utils::merge(transfers)));
   return absl::OkStatus();
 }
 
-absl::Status CoreMiniAxi_tb::ResetSync(bool enable) {
-  CHECK_OK(ResetAsync(enable));
+absl::Status CoreMiniAxi_tb::ResetSync(bool enable, bool verify) {
+  CHECK_OK(ResetAsync(enable, verify));
   absl::MutexLock lock(&transfer_queue_mtx_);
   transfer_queue_cv_.Wait(&transfer_queue_mtx_);
   return absl::OkStatus();
 }
 
-absl::Status CoreMiniAxi_tb::ResetAsync(bool enable) {
+absl::Status CoreMiniAxi_tb::ResetAsync(bool enable, bool verify) {
   absl::MutexLock lock(&transfer_queue_mtx_);
   uint8_t enable8 = enable ? 1 : 0;
   uint8_t enable_[4] = { enable8, 0, 0, 0 };;
+  std::vector<DataTransfer> transfers = {utils::Write(csr_addr_, enable_)};
+  if (verify) {
+    transfers.push_back(utils::Read(csr_addr_, 4));
+    transfers.push_back(utils::Expect(enable_, 4));
+  }
   transfer_queue_.push(
-      std::make_unique<TrafficDesc>(utils::merge(std::vector<DataTransfer>(
-          {utils::Write(csr_addr_, enable_),
-           utils::Read(csr_addr_, 4),
-           utils::Expect(enable_, 4)}))));
+      std::make_unique<TrafficDesc>(utils::merge(transfers)));
+  return absl::OkStatus();
+}
+
+absl::Status CoreMiniAxi_tb::ResetProgramSync(
+    std::optional<uint32_t> cycle_limit) {
+  CHECK_OK(ResetSync(true, /*verify=*/false));
+  CHECK_OK(ClockGateSync(true, /*verify=*/false));
+  absl::MutexLock lock(&transfer_queue_mtx_);
+  sim_thread_ops_.push([this, cycle_limit]() {
+    tohost_halt = false;
+    tohost_val = 0;
+    tohost_addr_.reset();
+    fromhost_addr_.reset();
+    invoked_halted_cb_ = false;
+    wfi_seen_ = false;
+    cycle_limit_reached_ = false;
+    cycle_limit_.reset();
+    tracer_.Reset();
+    if (cycle_limit.has_value()) {
+      cycle_limit_ = cycle() + cycle_limit.value();
+    }
+  });
+  while (transfer_in_progress_ || !transfer_queue_.empty() ||
+         !sim_thread_ops_.empty()) {
+    transfer_queue_cv_.Wait(&transfer_queue_mtx_);
+  }
   return absl::OkStatus();
 }
 
@@ -395,6 +551,84 @@ absl::Status CoreMiniAxi_tb::CheckStatusAsync() {
   return absl::OkStatus();
 }
 
+absl::Status CoreMiniAxi_tb::SaveCheckpoint(const std::string& path) {
+#ifdef VERILATOR_THREADS
+  return absl::UnimplementedError(
+      "Models verilated with --threads are not --savable");
+#else
+  {
+    absl::MutexLock lock(&transfer_queue_mtx_);
+    if (transfer_in_progress_ || !transfer_queue_.empty()) {
+      return absl::FailedPreconditionError("Host transfer in progress");
+    }
+  }
+  VerilatedSave os;
+  os.open(path.c_str());
+  if (!os.isOpen()) {
+    return absl::InternalError("Could not open " + path);
+  }
+  os << *core_;
+  os.write(&tohost_halt, sizeof(tohost_halt));
+  os.write(&tohost_val, sizeof(tohost_val));
+  os.write(&tohost_addr_, sizeof(tohost_addr_));
+  os.write(&fromhost_addr_, sizeof(fromhost_addr_));
+  xbar_.Save(os);
+  os.close();
+  return absl::OkStatus();
+#endif
+}
+
+absl::Status CoreMiniAxi_tb::RestoreCheckpointSync(const std::string& path) {
+#ifdef VERILATOR_THREADS
+  return absl::UnimplementedError(
+      "Models verilated with --threads are not --savable");
+#else
+  absl::MutexLock lock(&transfer_queue_mtx_);
+  restore_path_ = path;
+  while (restore_path_.has_value()) {
+    transfer_queue_cv_.Wait(&transfer_queue_mtx_);
+  }
+  return restore_status_;
+#endif
+}
+
+absl::Status CoreMiniAxi_tb::RestoreCheckpointAsync(const std::string& path) {
+#ifdef VERILATOR_THREADS
+  return absl::UnimplementedError(
+      "Models verilated with --threads are not --savable");
+#else
+  absl::MutexLock lock(&transfer_queue_mtx_);
+  restore_path_ = path;
+  return absl::OkStatus();
+#endif
+}
+
+absl::Status CoreMiniAxi_tb::RestoreCheckpoint(const std::string& path) {
+#ifdef VERILATOR_THREADS
+  return absl::UnimplementedError(
+      "Models verilated with --threads are not --savable");
+#else
+  VerilatedRestore is;
+  is.open(path.c_str());
+  if (!is.isOpen()) {
+    return absl::InternalError("Could not open " + path);
+  }
+  is >> *core_;
+  is.read(&tohost_halt, sizeof(tohost_halt));
+  is.read(&tohost_val, sizeof(tohost_val));
+  is.read(&tohost_addr_, sizeof(tohost_addr_));
+  is.read(&fromhost_addr_, sizeof(fromhost_addr_));
+  const bool xbar_ok = xbar_.Restore(is);
+  is.close();
+  if (!xbar_ok) {
+    return absl::DataLossError(
+        "External memory in " + path +
+        " is corrupt or does not match the configured size and banks");
+  }
+  return absl::OkStatus();
+#endif
+}
+
 void CoreMiniAxi_tb::TraceInstructions() {
 #if (KP_useRetirementBuffer == true)
 #define TRACE_INSTRUCTION(x) do { \
@@ -529,33 +763,57 @@ void CoreMiniAxi_tb::posedge() {
     }
   }
 
+  if (trace_has_triggers()) {
+#define TRACE_DISPATCH(x) \
+  if (debug_io_.dispatch_##x##_instFire) { \
+    TracePc(debug_io_.dispatch_##x##_instAddr.read().get_word(0)); \
+  }
+    REPEAT(TRACE_DISPATCH, 4);
+#undef TRACE_DISPATCH
+    if (core_io_dbus_valid && core_io_dbus_write) {
+      const int word = (core_io_dbus_addr % (KP_lsuDataBits / 8)) / 4;
+      TraceMarkerWrite(core_io_dbus_addr,
+                       debug_io_.dbus_bits_wdata.read().get_word(word));
+    }
+  }
+
   if (instr_trace_) {
     TraceInstructions();
   }
 
-  static bool invoked_halted_cb = false;
-  if ((io_halted || io_fault || tohost_halt) && !invoked_halted_cb) {
+  if (cycle_limit_.has_value() && cycle() >= cycle_limit_.value() &&
+      !invoked_halted_cb_) {
+    cycle_limit_reached_ = true;
+    if (instr_trace_) {
+      tracer_.PrintTrace();
+    }
+    invoked_halted_cb_ = true;
+    if (halted_cb_) {
+      halted_cb_.value()();
+    }
+  }
+
+  if ((io_halted || io_fault || tohost_halt) && !invoked_halted_cb_) {
     // If instruction tracing is enabled,
     // print the data about the instruction trace.
     if (instr_trace_) {
       tracer_.PrintTrace();
     }
-    invoked_halted_cb = true;
+    invoked_halted_cb_ = true;
     if (halted_cb_) {
       halted_cb_.value()();
     }
   }
 
-  static bool wfi_seen = false;
-  if (io_wfi && !wfi_seen) {
+  if (io_wfi && !wfi_seen_) {
     io_irq = true;
-    wfi_seen = true;
+    wfi_seen_ = true;
     if (wfi_cb_) {
       wfi_cb_.value()();
     }
-  } else if (!io_wfi && wfi_seen) {
+  } else if (!io_wfi && wfi_seen_) {
     io_irq = false;
-    wfi_seen = false;
+    wfi_seen_ = false;
   } else {
     io_irq = false;
   }
@@ -563,6 +821,19 @@ void CoreMiniAxi_tb::posedge() {
 
   if (!transfer_in_progress_) {
     absl::MutexLock lock(&transfer_queue_mtx_);
+    if (restore_path_.has_value() && !reset) {
+      restore_status_ = RestoreCheckpoint(restore_path_.value());
+      LOG_IF(ERROR, !restore_status_.ok()) << restore_status_;
+      restore_path_.reset();
+      transfer_queue_cv_.SignalAll();
+    }
+    if (!sim_thread_ops_.empty() && transfer_queue_.empty()) {
+      while (!sim_thread_ops_.empty()) {
+        sim_thread_ops_.front()();
+        sim_thread_ops_.pop();
+      }
+      transfer_queue_cv_.SignalAll();
+    }
     if (!transfer_queue_.empty()) {
       ITrafficDesc* transfer = transfer_queue_.front().get();
       tg_.addTransfers(transfer, 0, CoreMiniAxi_tb::axi_transaction_done_cb);
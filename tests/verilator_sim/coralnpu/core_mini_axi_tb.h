@@ -20,10 +20,12 @@
 #include <functional>
 #include <optional>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "tests/systemc/Xbar.h"
 #include "tests/systemc/instruction_trace.h"
 #include "tests/verilator_sim/sysc_tb.h"
@@ -47,6 +49,10 @@
 #define MODEL_HEADER_SUFFIX .h
 #define MODEL_HEADER STRINGIFY(VERILATOR_MODEL MODEL_HEADER_SUFFIX)
 #include MODEL_HEADER
+#define MODEL_DPI_HEADER_SUFFIX __Dpi.h
+#define MODEL_DPI_HEADER STRINGIFY(VERILATOR_MODEL MODEL_DPI_HEADER_SUFFIX)
+#include MODEL_DPI_HEADER
+#include "hw_sim/tcm_backdoor.h"
 
 #define PARAMS_HEADER_PREFIX hdl/chisel/src/coralnpu/
 #define PARAMS_HEADER_SUFFIX _parameters.h
@@ -184,20 +190,63 @@ struct CoreMiniAxi_tb : Sysc_tb {
   bool tohost_halt = false;
   uint32_t tohost_val = 0;
 
-  absl::Status LoadElfSync(const std::string& file_name);
-  absl::Status LoadElfAsync(const std::string& file_name);
+  // How LoadElf* moves an image into the core.
+  enum class LoadMode {
+    // AXI writes, each read back and compared by the traffic generator.
+    kVerify,
+    // AXI writes only.
+    kWriteOnly,
+    // AXI writes only; afterwards each segment is read through the SRAM
+    // backdoor and its CRC32C compared with the ELF's.
+    kWriteOnlyCrc,
+    // Segments are copied straight into the TCM SRAMs and external memory,
+    // without simulated time. Anything else is written over AXI.
+    kBackdoor,
+  };
+
+  // LoadElfSync returns once the image is in memory, with an error if the
+  // file cannot be read or a kWriteOnlyCrc check failed.
+  absl::Status LoadElfSync(const std::string& file_name,
+                           LoadMode mode = LoadMode::kVerify);
+  absl::Status LoadElfAsync(const std::string& file_name,
+                            LoadMode mode = LoadMode::kVerify);
   // ClockGate and Reset should be done in the correct order:
   // ClockGate(false); Reset(false);
   // OR
   // Reset(true); ClockGate(true);
-  absl::Status ClockGateSync(bool enable);
-  absl::Status ClockGateAsync(bool enable);
-  absl::Status ResetSync(bool enable);
-  absl::Status ResetAsync(bool enable);
+  // With `verify`, the CSR write is read back and compared.
+  absl::Status ClockGateSync(bool enable, bool verify = true);
+  absl::Status ClockGateAsync(bool enable, bool verify = true);
+  absl::Status ResetSync(bool enable, bool verify = true);
+  absl::Status ResetAsync(bool enable, bool verify = true);
+  // Holds the core in reset and clears the state of the previous program
+  // (tohost, halt and wfi tracking, and the instruction trace) so another
+  // ELF can be loaded into the same testbench. With `cycle_limit`, the
+  // halted callback also fires once that many cycles pass without the core
+  // halting; see cycle_limit_reached().
+  absl::Status ResetProgramSync(
+      std::optional<uint32_t> cycle_limit = std::nullopt);
+  // True if the halted callback fired because of ResetProgramSync's
+  // `cycle_limit` rather than the core halting.
+  bool cycle_limit_reached() const { return cycle_limit_reached_; }
   absl::Status CheckStatusSync();
   absl::Status CheckStatusAsync();
+  // Writes the model, the external memory with its timing state, and the
+  // tohost state to `path`. Must be called on the simulation thread (e.g.
+  // from the wfi or halted callback) while no host transfer is in progress.
+  absl::Status SaveCheckpoint(const std::string& path);
+  // Restores a checkpoint on the first clock edge after reset, in place of
+  // loading an ELF and releasing the core.
+  absl::Status RestoreCheckpointSync(const std::string& path);
+  absl::Status RestoreCheckpointAsync(const std::string& path);
 
   VERILATOR_MODEL* core() { return core_.get(); }
+  // The external memory and UART. Configure the memory before start().
+  Xbar& xbar() { return xbar_; }
+  // Committed instructions, recorded when instr_trace is set.
+  InstructionTrace& instruction_trace() { return tracer_; }
+  // Clock cycles simulated since reset.
+  uint32_t cycles() { return cycle(); }
 
   void EnqueueTransactionSync(std::vector<DataTransfer> transfers);
   void EnqueueTransactionAsync(std::vector<DataTransfer> transfers);
@@ -208,6 +257,14 @@ struct CoreMiniAxi_tb : Sysc_tb {
  private:
   void Connect();
   void TraceInstructions();
+  absl::Status RestoreCheckpoint(const std::string& path);
+  // Access to the TCMs and external memory that takes no simulated time.
+  // Only valid on the simulation thread.
+  bool BackdoorContains(uint32_t addr, size_t len);
+  bool BackdoorWrite(uint32_t addr, absl::Span<const uint8_t> data);
+  bool BackdoorRead(uint32_t addr, absl::Span<uint8_t> data);
+  TcmBackdoor* FindTcm(uint32_t addr, size_t len);
+  bool InMemory(uint32_t addr, size_t len);
 
   TLMTrafficGenerator tg_;
 
@@ -234,21 +291,43 @@ struct CoreMiniAxi_tb : Sysc_tb {
 
   std::unique_ptr<TrafficDesc> wrap_transfer_;
   std::unique_ptr<TrafficDesc> narrow_transfer_;
-  bool transfer_in_progress_;
+  bool transfer_in_progress_ = false;
 
   absl::Mutex transfer_queue_mtx_;
   absl::CondVar transfer_queue_cv_;
   std::queue<std::unique_ptr<TrafficDesc>> transfer_queue_;
+  // Backdoor loads and program resets, run on the simulation thread once
+  // transfer_queue_ is empty. Guarded by transfer_queue_mtx_, like
+  // load_status_.
+  std::queue<std::function<void()>> sim_thread_ops_;
+  absl::Status load_status_;
 
   void axi_transaction_done_cb_(TLMTrafficGenerator* gen, int threadId);
 
   static CoreMiniAxi_tb* singleton_;
   static CoreMiniAxi_tb* getSingleton() { return singleton_; }
-  static constexpr uint32_t csr_addr_ = 0x30000;
+  // CSR block location (MemoryRegions in Parameters.scala).
+  static constexpr uint32_t csr_addr_ = KP_tcmHighmem ? 0x200000 : 0x30000;
+  static constexpr uint32_t itcm_addr_ = 0x0;
+  static constexpr uint32_t itcm_size_ = KP_tcmHighmem ? 0x100000 : 0x2000;
+  static constexpr uint32_t dtcm_addr_ = KP_tcmHighmem ? 0x100000 : 0x10000;
+  static constexpr uint32_t dtcm_size_ = KP_tcmHighmem ? 0x100000 : 0x8000;
   std::unique_ptr<VERILATOR_MODEL> core_;
+  // Created on first use, once the model's DPI scopes exist.
+  std::unique_ptr<TcmBackdoor> itcm_backdoor_;
+  std::unique_ptr<TcmBackdoor> dtcm_backdoor_;
 
   std::optional<uint32_t> tohost_addr_;
   std::optional<uint32_t> fromhost_addr_;
+  std::optional<std::string> restore_path_;
+  // Outcome of the last restore, for RestoreCheckpointSync.
+  absl::Status restore_status_;
+
+  // Per-program state, cleared by ResetProgramSync.
+  bool invoked_halted_cb_ = false;
+  bool wfi_seen_ = false;
+  std::optional<uint32_t> cycle_limit_;
+  bool cycle_limit_reached_ = false;
 
   bool instr_trace_ = false;
   InstructionTrace tracer_;
@@ -34,6 +34,15 @@
 
 ABSL_FLAG(int, cycles, 100000000, "Simulation cycles");
 ABSL_FLAG(bool, trace, false, "Dump VCD trace");
+ABSL_FLAG(uint32_t, trace_start_cycle, 0, "First cycle written to the trace");
+ABSL_FLAG(uint32_t, trace_stop_cycle, UINT32_MAX,
+          "Cycle at which the trace stops");
+ABSL_FLAG(std::string, ibus_profile, "random",
+          "ibus ready: random, ready, wait[:N], prng:SEED[:P] or "
+          "replay:PATH");
+ABSL_FLAG(std::string, dbus_profile, "random",
+          "dbus ready: random, ready, wait[:N], prng:SEED[:P] or "
+          "replay:PATH");
 
 struct Core_tb : Sysc_tb {
   sc_in<bool> io_halted;
@@ -60,10 +69,12 @@ struct Core_tb : Sysc_tb {
 };
 
 static void Core_run(const char* name, const char* bin, const int cycles,
-                     const bool trace) {
+                     const bool trace, const BusProfile& ibus_profile,
+                     const BusProfile& dbus_profile) {
   VERILATOR_MODEL core(name);
   Core_tb tb("Core_tb", cycles, /* random= */ false);
   Core_if mif("Core_if", bin);
+  mif.set_bus_profiles(ibus_profile, dbus_profile);
   Debug_if dbg("Debug_if", &mif);
 
   sc_signal<bool> io_halted;
@@ -349,7 +360,10 @@ static void Core_run(const char* name, const char* bin, const int cycles,
   dbg.io_slog_data(io_slog_data);
 
   if (trace) {
-    tb.trace(&core);
+    TraceOptions trace_options;
+    trace_options.start_cycle = absl::GetFlag(FLAGS_trace_start_cycle);
+    trace_options.stop_cycle = absl::GetFlag(FLAGS_trace_stop_cycle);
+    tb.trace(&core, trace_options);
   }
 
   tb.start();
@@ -366,7 +380,14 @@ int sc_main(int argc, char *argv[]) {
   }
   const char* path = argv[1];
 
+  BusProfile ibus_profile;
+  BusProfile dbus_profile;
+  if (!ParseBusProfile(absl::GetFlag(FLAGS_ibus_profile), &ibus_profile) ||
+      !ParseBusProfile(absl::GetFlag(FLAGS_dbus_profile), &dbus_profile)) {
+    return 1;
+  }
+
   Core_run(Sysc_tb::get_name(argv[0]), path, absl::GetFlag(FLAGS_cycles),
-           absl::GetFlag(FLAGS_trace));
+           absl::GetFlag(FLAGS_trace), ibus_profile, dbus_profile);
   return 0;
 }
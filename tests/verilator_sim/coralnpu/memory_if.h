@@ -15,110 +15,94 @@
 #ifndef TESTS_VERILATOR_SIM_CORALNPU_MEMORY_IF_H_
 #define TESTS_VERILATOR_SIM_CORALNPU_MEMORY_IF_H_
 
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
-#include <map>
 
 #include "tests/verilator_sim/sysc_module.h"
 
 // A memory model base class
 struct Memory_if : Sysc_module {
   const int kPageSize = 4 * 1024;
-  const int kPageMask = ~(kPageSize - 1);
-
-  struct memory_page_t {
-    uint32_t addr;
-    uint8_t  data[4096];
-  };
+  // Memory below this address always exists, even past the end of the binary.
+  const uint32_t kMinMemoryBytes = 0x400000;
 
   Memory_if(sc_module_name n, const char* bin, int limit = -1) :
       Sysc_module(n) {
-    FILE *f = fopen(bin, "rb");
-
-    fseek(f, 0, SEEK_END);
-    int64_t fsize = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    uint8_t *fdata = new uint8_t[fsize];
-
-    fread(fdata, fsize, 1, f);
-    fclose(f);
+    int fd = open(bin, O_RDONLY);
+    struct stat sb;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+      printf("***ERROR Memory_if cannot open %s\n", bin);
+      exit(-1);
+    }
+    const int64_t fsize = sb.st_size;
 
     if (limit > 0 && fsize > limit) {
       printf("***ERROR Memory_if limit exceeded [%ld > %d]\n", fsize, limit);
       exit(-1);
     }
+    if (fsize > int64_t(UINT32_MAX) + 1) {
+      printf("***ERROR Memory_if binary exceeds 4GiB [%ld]\n", fsize);
+      exit(-1);
+    }
 
-    int addr = 0;
-    for (; addr < fsize; addr += kPageSize) {
-      const int64_t size = std::min(fsize - addr, int64_t(kPageSize));
-      AddPage(addr, size, fdata + addr);
+    // One flat region backs the whole address space, so an access is a
+    // bounds check and a memcpy. The binary is mapped copy-on-write over its
+    // start; everything past it reads as zero (removes need for .bss).
+    const uint64_t rounded = (fsize + kPageSize - 1) & ~uint64_t(kPageSize - 1);
+    size_ = std::max(rounded, uint64_t(kMinMemoryBytes));
+    void* base = mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+      printf("***ERROR Memory_if cannot allocate %lu bytes\n",
+             static_cast<unsigned long>(size_));
+      exit(-1);
     }
-    // Create pages for the rest of our memory space, that was not created
-    // for inserting the binary.
-    for (; addr < 0x400000; addr += kPageSize) {
-      AddPage(addr, kPageSize, nullptr);
+    if (fsize > 0 && mmap(base, fsize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      printf("***ERROR Memory_if cannot map %s\n", bin);
+      exit(-1);
     }
-
-    delete [] fdata;
+    close(fd);
+    memory_ = static_cast<uint8_t*>(base);
   }
 
+  ~Memory_if() { munmap(memory_, size_); }
+
   bool Read(uint32_t addr, int bytes, uint8_t* data) {
-    while (bytes > 0) {
-      const uint32_t maddr = addr & kPageMask;
-      const uint32_t offset = addr - maddr;
-      const int limit = kPageSize - offset;
-      const int len = std::min(bytes, limit);
-
-      if (!HasPage(maddr)) {
-        return false;
-      }
-
-      auto& p = page_[maddr];
-      uint8_t* d = p.data;
-      memcpy(data, d + offset, len);
+    if (!Contains(addr, bytes)) {
+      return false;
+    }
+    memcpy(data, memory_ + addr, bytes);
 #if 0
-      printf("READ  %08x", addr);
-      for (int i = 0; i < len; i++) {
-        printf(" %02x", data[i]);
-      }
-      printf("\n");
-#endif
-      addr += len;
-      data += len;
-      bytes -= len;
-      assert(bytes >= 0);
+    printf("READ  %08x", addr);
+    for (int i = 0; i < bytes; i++) {
+      printf(" %02x", data[i]);
     }
+    printf("\n");
+#endif
     return true;
   }
 
   bool Write(uint32_t addr, int bytes, const uint8_t* data) {
-    while (bytes > 0) {
-      const uint32_t maddr = addr & kPageMask;
-      const uint32_t offset = addr - maddr;
-      const int limit = kPageSize - offset;
-      const int len = std::min(bytes, limit);
-
-      if (!HasPage(maddr)) {
-        return false;
-      }
-
-      auto& p = page_[maddr];
-      uint8_t* d = p.data;
-      memcpy(d + offset, data, len);
+    if (!Contains(addr, bytes)) {
+      return false;
+    }
+    memcpy(memory_ + addr, data, bytes);
 #if 0
-      printf("WRITE %08x", addr);
-      for (int i = 0; i < len; i++) {
-        printf(" %02x", data[i]);
-      }
-      printf("\n");
-#endif
-      addr += len;
-      data += len;
-      bytes -= len;
-      assert(bytes >= 0);
+    printf("WRITE %08x", addr);
+    for (int i = 0; i < bytes; i++) {
+      printf(" %02x", data[i]);
     }
+    printf("\n");
+#endif
     return true;
   }
 
@@ -156,40 +140,11 @@ struct Memory_if : Sysc_module {
   }
 
  private:
-  std::map<uint32_t, memory_page_t> page_;
-
-  bool HasPage(const uint32_t addr) {
-    return page_.find(addr) != page_.end();
-  }
-
-  void AddPage(const uint32_t addr, const int bytes,
-               const uint8_t* data = nullptr) {
-    const uint32_t addrbase = addr & kPageMask;
-    if (addr != addrbase) {
-      printf("AddPage(%08x, %d)\n", addr, bytes);
-      assert(false && "AddPage: address not page aligned");
-    }
+  uint8_t* memory_ = nullptr;
+  uint64_t size_ = 0;
 
-    if (HasPage(addr)) {
-      printf("AddPage(%08x, %d)\n", addr, bytes);
-      assert(false && "AddPage: address already populated");
-    }
-
-    auto& p = page_[addr];
-    uint8_t* d = p.data;
-
-    if (bytes < kPageSize || data == nullptr) {
-#if 1
-      // remove need for .bss  (hacky?)
-      memset(d, 0x00, kPageSize);
-#else
-      memset(d, 0xcc, kPageSize);
-#endif
-    }
-
-    if (data) {
-      memcpy(d, data, bytes);
-    }
+  bool Contains(const uint32_t addr, const int bytes) const {
+    return bytes >= 0 && uint64_t(addr) + bytes <= size_;
   }
 };
 
@@ -0,0 +1,92 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Runs core_mini_axi_sim --batch over several programs on one testbench."""
+
+import json
+import os
+import subprocess
+import tempfile
+import unittest
+
+from bazel_tools.tools.python.runfiles import runfiles
+
+_CYCLES = 100000
+
+
+class CoreMiniAxiSimBatchTest(unittest.TestCase):
+
+    def setUp(self):
+        r = runfiles.Create()
+        self.sim = r.Rlocation(
+            "coralnpu_hw/tests/verilator_sim/core_mini_axi_sim")
+        self.noop = r.Rlocation("coralnpu_hw/tests/cocotb/noop.elf")
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.tmpdir.cleanup)
+
+    def run_batch(self, binaries, *flags):
+        batch = os.path.join(self.tmpdir.name, "batch.txt")
+        with open(batch, "w") as f:
+            f.write("# Programs for one testbench.\n\n")
+            f.write("\n".join(binaries) + "\n")
+        stats = os.path.join(self.tmpdir.name, "stats.json")
+        process = subprocess.run(
+            [self.sim, f"--batch={batch}", f"--cycles={_CYCLES}",
+             f"--stats_json={stats}", *flags],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        results = None
+        if os.path.exists(stats):
+            with open(stats) as f:
+                results = json.load(f)["results"]
+        return process, results
+
+    def test_all_pass(self):
+        process, results = self.run_batch([self.noop, self.noop])
+        self.assertEqual(process.returncode, 0, process.stdout)
+        self.assertEqual([r["status"] for r in results], ["PASS", "PASS"])
+        for result in results:
+            self.assertTrue(result["passed"])
+            self.assertTrue(result["halted"])
+            self.assertGreater(result["cycles"], 0)
+        self.assertIn("2 of 2 binaries passed", process.stdout)
+
+    def test_load_failure_does_not_stop_the_batch(self):
+        missing = os.path.join(self.tmpdir.name, "missing.elf")
+        process, results = self.run_batch([self.noop, missing, self.noop])
+        self.assertEqual(process.returncode, 1, process.stdout)
+        self.assertEqual([r["status"] for r in results],
+                         ["PASS", "LOAD_FAIL", "PASS"])
+        self.assertFalse(results[1]["passed"])
+        self.assertFalse(results[1]["halted"])
+        self.assertIn("2 of 3 binaries passed", process.stdout)
+
+    def test_trace_symbols_are_rejected(self):
+        process, results = self.run_batch([self.noop],
+                                          "--trace_start_pc=main")
+        self.assertNotEqual(process.returncode, 0)
+        self.assertIsNone(results)
+        self.assertIn("must be an address with --batch", process.stdout)
+
+    def test_checkpoints_are_rejected(self):
+        for flag in ("--save_checkpoint", "--restore_checkpoint"):
+            checkpoint = os.path.join(self.tmpdir.name, "checkpoint")
+            process, results = self.run_batch([self.noop],
+                                              f"{flag}={checkpoint}")
+            self.assertNotEqual(process.returncode, 0)
+            self.assertIsNone(results)
+            self.assertIn("cannot be used with --batch", process.stdout)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -15,60 +15,110 @@
 #ifndef TESTS_VERILATOR_SIM_FIFO_H_
 #define TESTS_VERILATOR_SIM_FIFO_H_
 
+#include <stdlib.h>
+
+#include <cstddef>
+#include <utility>
 #include <vector>
 
+// Rounds up to a power of two, so ring indices wrap with a mask.
+inline size_t fifo_capacity(size_t n) {
+  size_t capacity = 1;
+  while (capacity < n) capacity <<= 1;
+  return capacity;
+}
+
 // A SystemC CRT transaction queue.
+//
+// Entries live in a power-of-two ring, so writes and reads from the front are
+// O(1). The ring doubles when a write finds it full; `capacity` only sets
+// where it starts.
 
 template <typename T>
 class fifo_t {
  public:
-  bool empty() { return entries_.empty(); }
+  explicit fifo_t(int capacity = 16)
+      : entries_(fifo_capacity(capacity)), mask_(entries_.size() - 1) {}
 
-  void write(T v) { entries_.emplace_back(v); }
+  bool empty() { return count_ == 0; }
+
+  void write(T v) {
+    if (count_ == int(entries_.size())) grow();
+    at(count_) = std::move(v);
+    count_++;
+  }
 
   bool read(T& v) {
-    if (entries_.empty()) return false;
-    v = entries_.at(0);
-    entries_.erase(entries_.begin());
+    if (empty()) return false;
+    v = std::move(at(0));
+    head_ = (head_ + 1) & mask_;
+    count_--;
     return true;
   }
 
   bool next(T& v, int index = 0) {
     if (index >= count()) return false;
-    v = entries_.at(index);
+    v = at(index);
     return true;
   }
 
   bool rand(T& v) {
-    if (entries_.empty()) return false;
+    if (empty()) return false;
     int index = ::rand() % count();
-    v = entries_.at(index);
+    v = at(index);
     return true;
   }
 
-  void clear() { entries_.clear(); }
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+  }
 
+  // Removing from either end is O(1); from the middle, the shorter side
+  // moves up by one.
   bool remove(int index = 0) {
     if (index >= count()) return false;
-    entries_.erase(entries_.begin() + index);
+    if (index < count_ / 2) {
+      for (int i = index; i > 0; --i) {
+        at(i) = std::move(at(i - 1));
+      }
+      head_ = (head_ + 1) & mask_;
+    } else {
+      for (int i = index; i < count_ - 1; ++i) {
+        at(i) = std::move(at(i + 1));
+      }
+    }
+    count_--;
     return true;
   }
 
+  // Fisher-Yates, in place.
   void shuffle() {
-    const int count = entries_.size();
-    if (count < 2) return;
-    for (int i = 0; i < count; ++i) {
-      const int index = ::rand() % count;
-      T v = entries_.at(index);
-      entries_.erase(entries_.begin() + index);
-      entries_.emplace_back(v);
+    for (int i = count_ - 1; i > 0; --i) {
+      const int j = ::rand() % (i + 1);
+      std::swap(at(i), at(j));
     }
   }
 
-  int count() { return entries_.size(); }
+  int count() { return count_; }
 
  private:
+  T& at(int index) { return entries_[(head_ + index) & mask_]; }
+
+  void grow() {
+    std::vector<T> entries(entries_.size() * 2);
+    for (int i = 0; i < count_; ++i) {
+      entries[i] = std::move(at(i));
+    }
+    entries_.swap(entries);
+    mask_ = entries_.size() - 1;
+    head_ = 0;
+  }
+
   std::vector<T> entries_;
+  size_t mask_;
+  size_t head_ = 0;
+  int count_ = 0;
 };
 
 #endif  // TESTS_VERILATOR_SIM_FIFO_H_
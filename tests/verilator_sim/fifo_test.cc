@@ -0,0 +1,88 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks fifo_t's ring against a std::deque.
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "tests/verilator_sim/fifo.h"
+#include "tests/verilator_sim/test_check.h"
+
+namespace {
+
+bool Matches(fifo_t<int>& fifo, const std::deque<int>& ref) {
+  if (fifo.count() != static_cast<int>(ref.size())) return false;
+  for (int i = 0; i < fifo.count(); ++i) {
+    int v;
+    if (!fifo.next(v, i) || v != ref[i]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+
+  // Random writes, reads and removes, starting small so the ring wraps and
+  // grows.
+  fifo_t<int> fifo(2);
+  std::deque<int> ref;
+  srand(1);
+  bool matched = true;
+  for (int i = 0; i < 20000 && matched; ++i) {
+    // Writes slightly outpace reads and removes, so the queue slowly grows.
+    const int op = ::rand() % 5;
+    if (op < 3) {
+      fifo.write(i);
+      ref.push_back(i);
+    } else if (op == 3) {
+      int v = -1;
+      const bool read = fifo.read(v);
+      matched &= read == !ref.empty();
+      if (read) {
+        matched &= v == ref.front();
+        ref.pop_front();
+      }
+    } else if (!ref.empty()) {
+      const int index = ::rand() % ref.size();
+      matched &= fifo.remove(index);
+      ref.erase(ref.begin() + index);
+    }
+    matched &= Matches(fifo, ref);
+  }
+  ok &= Check(matched, "fifo_t matches deque");
+
+  // Shuffle permutes without losing entries.
+  fifo.clear();
+  ok &= Check(fifo.empty() && !fifo.remove(), "clear");
+  for (int i = 0; i < 100; ++i) fifo.write(i);
+  fifo.shuffle();
+  std::vector<int> shuffled;
+  int v;
+  while (fifo.read(v)) shuffled.push_back(v);
+  std::vector<int> sorted = shuffled;
+  std::sort(sorted.begin(), sorted.end());
+  bool identity = true;
+  for (int i = 0; i < 100; ++i) {
+    identity &= shuffled[i] == i;
+    ok &= Check(sorted[i] == i, "shuffle keeps entries");
+  }
+  ok &= Check(!identity, "shuffle permutes");
+
+  return TestResult(ok);
+}
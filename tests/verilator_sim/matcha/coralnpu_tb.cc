@@ -34,6 +34,9 @@
 
 ABSL_FLAG(int, cycles, 100000000, "Simulation cycles");
 ABSL_FLAG(bool, trace, false, "Dump VCD trace");
+ABSL_FLAG(uint32_t, trace_start_cycle, 0, "First cycle written to the trace");
+ABSL_FLAG(uint32_t, trace_stop_cycle, UINT32_MAX,
+          "Cycle at which the trace stops");
 
 struct CoralNPU_tb : Sysc_tb {
   sc_in<bool> io_halted;
@@ -130,7 +133,10 @@ static void CoralNPU_run(const char* name, const char* bin, const int cycles,
   dbg.io_slog_data(slog_data);
 
   if (trace) {
-    tb.trace(&core);
+    TraceOptions trace_options;
+    trace_options.start_cycle = absl::GetFlag(FLAGS_trace_start_cycle);
+    trace_options.stop_cycle = absl::GetFlag(FLAGS_trace_stop_cycle);
+    tb.trace(&core, trace_options);
   }
 
   tb.start();
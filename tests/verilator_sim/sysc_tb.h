@@ -18,8 +18,13 @@
 // A SystemC baseclass for constrained random testing of Verilated RTL.
 #include <systemc.h>
 
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 
 #include "tests/verilator_sim/fifo.h"
 // sc_core needs to be included before verilator header
@@ -99,6 +104,23 @@ struct base {
   }
 };
 
+// Selects the part of a run that is written to the FST trace. Tracing is on
+// while the cycle (counted from the end of reset) is in
+// [start_cycle, stop_cycle) and the trigger is armed. The trigger starts
+// armed unless start_pc or marker_addr is set; it is armed when start_pc
+// issues or firmware writes a nonzero value to marker_addr, and disarmed
+// when stop_pc issues or firmware writes zero to marker_addr. PC and marker
+// events are reported by the testbench through TracePc/TraceMarkerWrite.
+struct TraceOptions {
+  uint32_t start_cycle = 0;
+  uint32_t stop_cycle = UINT32_MAX;
+  std::optional<uint32_t> start_pc;
+  std::optional<uint32_t> stop_pc;
+  std::optional<uint32_t> marker_addr;
+  // Edges dumped between flushes by the trace writer thread.
+  int flush_edges = 4096;
+};
+
 // Base class for testbench {posedge & negedge}.
 struct Sysc_tb : public sc_module {
   sc_clock clock;
@@ -133,6 +155,7 @@ struct Sysc_tb : public sc_module {
   }
 
   ~Sysc_tb() {
+    StopTraceWriter();
     if (tf_) {
       tf_->dump(sim_time_);  // last falling edge
       tf_->close();
@@ -156,6 +179,7 @@ struct Sysc_tb : public sc_module {
     started_ = true;
     sc_start();
 
+    StopTraceWriter();
     if (tf_) {
       tf_->dump(sim_time_++);  // last falling edge
       tf_->close();
@@ -166,6 +190,11 @@ struct Sysc_tb : public sc_module {
 
   template <typename T>
   void trace(T* design, const char *name = "") {
+    trace(design, TraceOptions(), name);
+  }
+
+  template <typename T>
+  void trace(T* design, const TraceOptions& options, const char *name = "") {
     if (!strlen(name)) {
       name = design->name();
     }
@@ -183,6 +212,11 @@ struct Sysc_tb : public sc_module {
     tf_->open(path.c_str());
     printf("\nInfo: default timescale unit used for tracing: 1 ps (%s)\n",
            path.c_str());
+
+    trace_options_ = options;
+    trace_armed_ = !options.start_pc && !options.marker_addr;
+    tracing_ = true;
+    writer_ = std::thread(&Sysc_tb::TraceWriter, this);
   }
 
   static char *get_name(char *s) {
@@ -246,26 +280,116 @@ struct Sysc_tb : public sc_module {
     return sim_time_ / 2;  // posedge + negedge
   }
 
+  // True when the trace window waits on TracePc or TraceMarkerWrite, so
+  // testbenches only decode those events when they matter.
+  bool trace_has_triggers() const {
+    return tracing_ && (trace_options_.start_pc || trace_options_.stop_pc ||
+                        trace_options_.marker_addr);
+  }
+
+  // Reports an issued instruction to the trace window.
+  void TracePc(uint32_t pc) {
+    if (trace_options_.start_pc == pc) {
+      trace_armed_ = true;
+    } else if (trace_options_.stop_pc == pc) {
+      trace_armed_ = false;
+    }
+  }
+
+  // Reports a firmware store to the trace window.
+  void TraceMarkerWrite(uint32_t addr, uint32_t value) {
+    if (trace_options_.marker_addr == addr) {
+      trace_armed_ = value != 0;
+    }
+  }
+
  private:
   const bool random_;
   const int loops_;
   int loop_;
   bool error_;
-  bool started_;
+  bool started_ = false;
 
   sc_in<bool> clock_;
 
   uint32_t sim_time_ = 0;
   VerilatedFstC *tf_ = nullptr;
 
+  // Trace window state, owned by the simulation thread.
+  bool tracing_ = false;
+  bool trace_armed_ = true;
+  TraceOptions trace_options_;
+  int edges_since_flush_ = 0;
+
+  // The writer thread flushes the FST buffers so the simulation thread only
+  // dumps. At most one flush is outstanding, which bounds the buffered trace
+  // to 2 * flush_edges edges.
+  std::thread writer_;
+  std::mutex writer_mtx_;
+  std::condition_variable writer_cv_;
+  bool flush_pending_ = false;
+  bool writer_stop_ = false;
+
+  void TraceWriter() {
+    std::unique_lock<std::mutex> lock(writer_mtx_);
+    while (true) {
+      writer_cv_.wait(lock, [this] { return flush_pending_ || writer_stop_; });
+      if (flush_pending_) {
+        lock.unlock();
+        tf_->flush();
+        lock.lock();
+        flush_pending_ = false;
+        writer_cv_.notify_all();
+      }
+      if (writer_stop_) {
+        return;
+      }
+    }
+  }
+
+  void RequestFlush() {
+    std::unique_lock<std::mutex> lock(writer_mtx_);
+    writer_cv_.wait(lock, [this] { return !flush_pending_; });
+    flush_pending_ = true;
+    writer_cv_.notify_all();
+  }
+
+  void StopTraceWriter() {
+    if (!writer_.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(writer_mtx_);
+      writer_stop_ = true;
+    }
+    writer_cv_.notify_all();
+    writer_.join();
+  }
+
+  void trace_edge() {
+    if (!started_) return;
+    const uint32_t time = sim_time_++;
+    if (!tracing_ || !trace_armed_) return;
+    const uint32_t cycle = time / 2;
+    if (cycle < trace_options_.start_cycle ||
+        cycle >= trace_options_.stop_cycle) {
+      return;
+    }
+    tf_->dump(time);
+    if (++edges_since_flush_ >= trace_options_.flush_edges) {
+      edges_since_flush_ = 0;
+      RequestFlush();
+    }
+  }
+
   void tb_posedge() {
-    if (tf_ && started_) { tf_->dump(sim_time_++); tf_->flush(); }
+    trace_edge();
     if (reset) return;
     posedge();
   }
 
   void tb_negedge() {
-    if (tf_ && started_) { tf_->dump(sim_time_++); tf_->flush(); }
+    trace_edge();
     if (reset) return;
     negedge();
   }
@@ -0,0 +1,40 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_VERILATOR_SIM_TEST_CHECK_H_
+#define TESTS_VERILATOR_SIM_TEST_CHECK_H_
+
+#include <iostream>
+
+// Helpers for the plain main() unit tests. Checks are accumulated with
+//   ok &= Check(condition, "what");
+// so that one run reports every failure, and main() ends with
+//   return TestResult(ok);
+
+inline bool Check(bool condition, const char* message) {
+  if (!condition) {
+    std::cout << "FAILED: " << message << std::endl;
+  }
+  return condition;
+}
+
+// Prints PASSED if `ok` and returns the exit code for main().
+inline int TestResult(bool ok) {
+  if (ok) {
+    std::cout << "PASSED" << std::endl;
+  }
+  return ok ? 0 : 1;
+}
+
+#endif  // TESTS_VERILATOR_SIM_TEST_CHECK_H_